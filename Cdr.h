@@ -8,6 +8,8 @@ extern "C"
 #endif /* __cplusplus */
 
 
+#include <stdint.h>
+
 #include "cxdata.h"
 #include "cda.h"
 #include "Knobs_types.h"
@@ -99,8 +101,110 @@ typedef void (*CdrSimpleChanNewValCB_t)(int handle, double val, void *privptr);
 
 int   CdrRegisterSimpleChan(const char *name, const char *argv0,
                             CdrSimpleChanNewValCB_t cb, void *privptr);
+/* Batch registration: fills handles[count] (-1 on failure) and, if
+   non-NULL, errs[count] with 0 or errno-codes; privptrs may be NULL.
+   Returns # of successfully registered names, or -1 on bad arguments */
+int   CdrRegisterSimpleChans(const char **names, int count, const char *argv0,
+                             CdrSimpleChanNewValCB_t cb, void **privptrs,
+                             int *handles, int *errs);
+/* Loads listed subsystems in advance, one by one (description loading
+   isn't thread-safe).  Fills errs[count] (if non-NULL) with 0 or
+   errno-codes; returns # of loaded subsystems (including those already
+   loaded), or -1 on bad arguments */
+int   CdrSimplePreloadSubsystems(const char **names, int count, const char *argv0,
+                                 int *errs);
+
+/* Unregistration; a subsystem is unloaded (cda server, grouplist,
+   description) when its last scalar/big channel goes, and a bigc server
+   connection -- when its last bigc does.  Subsystem settings (dispatch,
+   processing, dependencies, local registers, cycle callback) survive the
+   unload and apply on the next load.  Calls from callbacks are allowed:
+   the release is then deferred until dispatch returns (until the next
+   scheduler iteration, for callbacks invoked by cda).  In threaded mode a
+   released handle isn't reused while queued records may still refer to it */
+int   CdrUnregisterSimpleChan(int handle);
 int   CdrSetSimpleChanVal  (int handle, double  val);
 int   CdrGetSimpleChanVal  (int handle, double *val_p);
+/* Async writes: requests are queued per channel, keeping only the last
+   value, and written out per subsystem after its server cycle (or on
+   CdrFlushSimpleWrites(), subsys=NULL -- all subsystems); each is still
+   a separate knob write, only coalesced.  A direct Set cancels a pending
+   async write.  Completion is reported to the write callback with err=0
+   or an errno-code, after all writes of the subsystem are done */
+typedef void (*CdrSimpleWriteCB_t)(int handle, double val, int err, void *privptr);
+
+int   CdrSetSimpleChanValAsync(int handle, double val);
+int   CdrFlushSimpleWrites    (const char *subsys, const char *argv0);
+int   CdrSetSimpleWriteCB     (CdrSimpleWriteCB_t cb, void *privptr);
+
+/* Value history: a preallocated ring of size points (0 -- off), filled
+   every server cycle; Get copies the newest min(max,available) points,
+   oldest first, with their timestamps (seconds since the Epoch).
+   Either array may be NULL.  Returns # of points copied */
+int   CdrActivateSimpleChanHistory(int handle, int size);
+int   CdrGetSimpleChanHistory     (int handle, double *vals, double *timestamps, int max);
+
+/* Vector versions: all handles are checked first, an invalid one fails
+   the whole Set; Get fills invalid ones with NAN/-1 and returns -1 */
+int   CdrGetSimpleChanVals (const int *handles, int n, double *out, int *rflags_out);
+int   CdrSetSimpleChanVals (const int *handles, const double *vals, int n);
+
+/* Callback dispatch modes: ALWAYS calls back on every server cycle
+   (default, usable as a heartbeat), ONCHANGE only when value or rflags
+   differ from the previously delivered ones; channels in INHERIT mode
+   (default) use their subsystem's mode */
+enum
+{
+    CDR_SIMPLE_DISPATCH_INHERIT  = 0,
+    CDR_SIMPLE_DISPATCH_ALWAYS   = 1,
+    CDR_SIMPLE_DISPATCH_ONCHANGE = 2,
+};
+
+int   CdrSetSimpleChanDispatch  (int handle, int mode);
+int   CdrSetSimpleSubsysDispatch(const char *subsys, const char *argv0, int mode);
+
+/* Filtering, applied in C after the dispatch mode, before any callback
+   (and before queueing in threaded mode).  max_rate (Hz) limits
+   deliveries, coalescing to the latest value; an update is suppressed
+   if it differs from the last delivered value by no more than
+   deadband_abs or deadband_rel*|last| (rflags changes always pass).
+   0 disables the respective check.  Stats count updates delivered and
+   suppressed since registration */
+int   CdrSetSimpleChanFilter     (int handle, double max_rate,
+                                  double deadband_abs, double deadband_rel);
+int   CdrGetSimpleChanFilterStats(int handle,
+                                  unsigned int *delivered_p,
+                                  unsigned int *suppressed_p);
+
+/* Per-subsystem cycle callback: called once per server cycle with all
+   channels updated in it (per their dispatch modes; channels registered
+   with cb=NULL are included too).  Arrays are valid during the call only */
+typedef void (*CdrSimpleCycleCB_t)(int count, const int *handles,
+                                   const double *vals, const int *rflags,
+                                   void *privptr);
+
+int   CdrSetSimpleSubsysCycleCB(const char *subsys, const char *argv0,
+                                CdrSimpleCycleCB_t cb, void *privptr);
+
+/* Processing modes: ALL (default) evaluates the whole subsystem every
+   cycle; REGISTERED only knobs of its registered channels, plus knobs
+   writing local registers they read (found by scanning formulas, up to
+   the first RET), transitively.  Dependencies the scan can't see (e.g.
+   registers accessed after a GOTO past RET) may be added explicitly */
+enum
+{
+    CDR_SIMPLE_PROCESS_ALL        = 0,
+    CDR_SIMPLE_PROCESS_REGISTERED = 1,
+};
+
+int   CdrSetSimpleSubsysProcessing(const char *subsys, const char *argv0, int mode);
+int   CdrAddSimpleSubsysDependency(const char *subsys, const char *argv0,
+                                   const char *knobname);
+
+/* Local registers are allocated per subsystem, as many as its formulas
+   address (1000 if some compute the register number); an explicit count
+   overrides that, keeps values and survives reloads */
+int   CdrSetSimpleSubsysLocalRegs(const char *subsys, const char *argv0, int count);
 
 
 typedef void (*CdrSimpleChanNewBigCB_t)(int handle,             void *privptr);
@@ -108,12 +212,277 @@ typedef void (*CdrSimpleChanNewBigCB_t)(int handle,             void *privptr);
 int   CdrRegisterSimpleBigc(const char *name, const char *argv0,
                             size_t max_datasize,
                             CdrSimpleChanNewBigCB_t cb, void *privptr);
+int   CdrRegisterSimpleBigcs(const char **names, int count, const char *argv0,
+                             size_t max_datasize,
+                             CdrSimpleChanNewBigCB_t cb, void **privptrs,
+                             int *handles, int *errs);
+int   CdrUnregisterSimpleBigc(int handle);
 int   CdrGetSimpleBigcData (int handle, int byte_ofs, int byte_size, void *buf);
 int   CdrSetSimpleBigcData (int handle, int byte_ofs, int byte_size, void *buf, int dataunits);
+/* Read-only view of the current data, copied from cda at most once per
+   event; *gen_p changes with every new frame.  The view stays intact
+   (later events don't touch it) until CdrReleaseSimpleBigcView(); views
+   are counted, so each Acquire needs its own Release, and the data stays
+   intact until the last one */
+int   CdrAcquireSimpleBigcView(int handle, const void **data_p, size_t *size_p, int *gen_p);
+int   CdrReleaseSimpleBigcView(int handle);
+
+/* Frame ring: nframes slots of max_datasize bytes each, filled on every
+   event; when full, either the oldest queued frame or the newly arrived
+   one is dropped.  nframes=0 disables the ring.  Pop returns 1 if a frame
+   was taken (copying at most bufsize bytes, *size_p gets the full size),
+   0 if the ring is empty */
+enum
+{
+    CDR_SIMPLE_RING_OVERWRITE_OLDEST = 0,
+    CDR_SIMPLE_RING_DROP_NEWEST      = 1,
+};
+
+int   CdrSetSimpleBigcRing (int handle, int nframes, int policy);
+int   CdrPopSimpleBigcFrame(int handle, void *buf, size_t bufsize,
+                            size_t *size_p, int *tag_p, int *rflags_p);
+int   CdrGetSimpleBigcRingStats(int handle, int *used_p,
+                                unsigned int *pushed_p, unsigned int *dropped_p);
 int   CdrGetSimpleBigcStats(int handle, int *age_p, int *rflags_p);
 int   CdrGetSimpleBigcParam(int handle, int n, int *val_p);
 int   CdrSetSimpleBigcParam(int handle, int n, int  val);
+/* Range versions: params [start, start+count) in one request */
+int   CdrGetSimpleBigcParams(int handle, int start, int count, int       *vals);
+int   CdrSetSimpleBigcParams(int handle, int start, int count, const int *vals);
+
+/* Decoding: samples [first, first+count) of the current frame (or of a
+   held view) are converted into phys=raw/r-d, with the best SIMD kernel
+   available (AVX2/SSE4.1/NEON/portable, chosen at runtime).  Samples are
+   signed ints of dataunits=1/2/4 bytes; defaults are 4, r=1, d=0.
+   Returns the # of samples converted (count is clipped to the frame);
+   buf=NULL just returns that # */
+int   CdrSetSimpleBigcScale  (int handle, int dataunits, double r, double d);
+int   CdrGetSimpleBigcFloats (int handle, int first, int count, float  *buf);
+int   CdrGetSimpleBigcDoubles(int handle, int first, int count, double *buf);
+const char *CdrSimpleBigcDecodeKernel(void);
+
+/* Reductions, computed (in physical units, see CdrSetSimpleBigcScale())
+   in one vectorized pass as each frame arrives, before callbacks, so
+   consumers fetch small results without touching the frame:
+   STATS    -- count/min/max/mean/RMS of the frame;
+   DECIMATE -- the frame is split into min(decim_points,samples) equal
+               buckets, min and max of each kept (a display envelope).
+   Results refer to frame 'generation' (as with views), count=0 before
+   the first one.  Get* return -1 with errno=ENOENT if that reduction
+   is off; Decimated returns the # of points copied. */
+enum
+{
+    CDR_SIMPLE_REDUCE_STATS    = 1 << 0,
+    CDR_SIMPLE_REDUCE_DECIMATE = 1 << 1,
+};
 
+typedef struct
+{
+    int     generation;
+    int     count;          // Samples in the frame
+    double  min;
+    double  max;
+    double  mean;
+    double  rms;
+} CdrSimpleBigcFrameStats_t;
+
+int   CdrSetSimpleBigcReduction (int handle, int flags, int decim_points);
+int   CdrGetSimpleBigcFrameStats(int handle, CdrSimpleBigcFrameStats_t *stats);
+int   CdrGetSimpleBigcDecimated (int handle, double *mins, double *maxs,
+                                 int max_points, int *gen_p);
+
+/* Threaded mode: the cda event loop runs in a library thread (so the
+   application must not run its own cx main loop), and instead of
+   calling callbacks, updates are put into a lock-free queue.  The queue
+   fd becomes readable when records arrive; consumers in any thread
+   fetch them with CdrSimpleDrainQueue().  For bigc records val is the
+   frame generation (see CdrAcquireSimpleBigcView()), write records
+   report async writes' completion.  Cycle callbacks have no record
+   kind, so starting with any set (or setting one while running) fails
+   with EBUSY.  Stop wakes the loop itself and may be called at any time
+   (also concurrently with draining). */
+enum
+{
+    CDR_SIMPLE_UPD_CHAN  = 0,
+    CDR_SIMPLE_UPD_BIGC  = 1,
+    CDR_SIMPLE_UPD_WRITE = 2,  // Async write done, rflags is err
+};
+
+typedef struct
+{
+    int     kind;       // CDR_SIMPLE_UPD_*
+    int     handle;
+    double  val;
+    int     rflags;
+    double  timestamp;  // Seconds since the Epoch
+} CdrSimpleUpdate_t;
+
+int   CdrSimpleStartThread  (int queue_size);
+int   CdrSimpleStopThread   (void);
+int   CdrSimpleQueueFd      (void);
+int   CdrSimpleDrainQueue   (CdrSimpleUpdate_t *recs, int max);
+int   CdrSimpleGetQueueStats(unsigned int *pushed_p, unsigned int *dropped_p);
+
+/* Drains the queue calling the registered callbacks in the caller's
+   thread, so that an epoll/select loop (watching CdrSimpleQueueFd())
+   can drive them without a cx/Qt main loop.  Processes at most
+   max_events records (<=0 -- all pending); returns the number
+   processed.  Channel, bigc and write callbacks are called without
+   the library lock held, so they don't stall the event thread; a
+   channel unregistered from another thread may still get one. */
+int   CdrSimpleProcessPending(int max_events);
+
+
+/* Instrumentation: opt-in counters and latency histograms.  Times are
+   in ns, recorded in log-linear buckets: values <2*SUB go to bucket
+   #value, others to ((e-SUB_BITS+1)*SUB + next SUB_BITS bits of value),
+   where e=floor(log2(value)).  'elapsed' is seconds since enabling or
+   reset, for rates.  Snapshots of not-yet-active objects are zeroed. */
+enum
+{
+    CDR_SIMPLE_HIST_SUB_BITS = 2,
+    CDR_SIMPLE_HIST_SUB      = 1 << CDR_SIMPLE_HIST_SUB_BITS,
+    CDR_SIMPLE_HIST_BUCKETS  = (64 - CDR_SIMPLE_HIST_SUB_BITS + 1) * CDR_SIMPLE_HIST_SUB,
+};
+
+typedef struct
+{
+    uint64_t  count;
+    uint64_t  sum;
+    uint64_t  min;
+    uint64_t  max;
+    uint32_t  buckets[CDR_SIMPLE_HIST_BUCKETS];
+} CdrSimpleHist_t;
+
+typedef struct
+{
+    double           elapsed;
+    uint64_t         events;        // EventProc invocations
+    CdrSimpleHist_t  process_time;  // Grouplist processing
+} CdrSimpleSubsysPerf_t;
+
+typedef struct
+{
+    double           elapsed;
+    uint64_t         callbacks;
+    CdrSimpleHist_t  cb_time;
+    CdrSimpleHist_t  queue_delay;   // Threaded mode: from event to callback
+} CdrSimpleChanPerf_t;
+
+typedef struct
+{
+    double           elapsed;
+    uint64_t         events;        // Frames arrived
+    uint64_t         callbacks;
+    uint64_t         bytes_read;    // By CdrGetSimpleBigcData() and views
+    CdrSimpleHist_t  cb_time;
+    CdrSimpleHist_t  age;           // As returned by CdrGetSimpleBigcStats(), not ns
+} CdrSimpleBigcPerf_t;
+
+int   CdrSimpleEnablePerf   (int on);
+int   CdrSimpleResetPerf    (void);
+int   CdrGetSimpleSubsysPerf(const char *subsys, CdrSimpleSubsysPerf_t *perf);
+int   CdrGetSimpleChanPerf  (int handle, CdrSimpleChanPerf_t *perf);
+int   CdrGetSimpleBigcPerf  (int handle, CdrSimpleBigcPerf_t *perf);
+
+
+/* Binary logging: every server cycle, each logged channel appends a
+   fixed-width record.  A background thread writes them out of a double
+   buffer, so the event loop never waits for disk; records arriving
+   while both buffers are full are dropped (and counted).
+   A file is CdrSimpleLogHeader_t, then num_chans CdrSimpleLogChanEntry_t
+   (each followed by its '\0'-terminated name, padded to 8 bytes), then
+   records from data_offset on.  All fields are in host byte order.
+   With rotate_size>0 files are named "filename.0000", "filename.0001"...,
+   each self-contained and at most rotate_size bytes long.
+   fsync_interval>0 -- fdatasync() at most that often (in seconds) and on
+   rotation/close.  Open returns log_id (>0). */
+#define CDR_SIMPLE_LOG_MAGIC "CdrSLog1"
+enum {CDR_SIMPLE_LOG_VERSION = 1};
+
+typedef struct
+{
+    char      magic[8];     // CDR_SIMPLE_LOG_MAGIC, no '\0'
+    uint32_t  version;
+    uint32_t  record_size;
+    uint32_t  num_chans;
+    uint32_t  data_offset;
+    double    start_time;   // Seconds since the Epoch
+} CdrSimpleLogHeader_t;
+
+typedef struct
+{
+    int32_t   handle;
+    uint32_t  name_len;
+} CdrSimpleLogChanEntry_t;
+
+typedef struct
+{
+    double    timestamp;    // Seconds since the Epoch
+    double    value;
+    int32_t   handle;
+    int32_t   rflags;
+} CdrSimpleLogRecord_t;
+
+int   CdrOpenSimpleLog    (const char *filename, const int *handles, int count,
+                           size_t rotate_size, double fsync_interval);
+int   CdrCloseSimpleLog   (int log_id);
+int   CdrGetSimpleLogStats(int log_id, uint64_t *written_p, uint64_t *dropped_p);
+
+/* Memory-mapped reader of one log file (needs no other library calls) */
+typedef struct
+{
+    void                        *map;
+    size_t                       map_size;
+    const CdrSimpleLogHeader_t  *header;
+    const CdrSimpleLogRecord_t  *records;
+    size_t                       num_records;
+} CdrSimpleLogFile_t;
+
+int         CdrOpenSimpleLogFile    (const char *path, CdrSimpleLogFile_t *lf);
+const char *CdrSimpleLogFileChanName(const CdrSimpleLogFile_t *lf, int handle);
+int         CdrCloseSimpleLogFile   (CdrSimpleLogFile_t *lf);
+
+
+/* Snapshots: values of channels (handles=NULL -- all registered ones,
+   count=0 -- none), captured in one pass into a memory-mappable file:
+   CdrSimpleSnapHeader_t, num_chans CdrSimpleSnapEntry_t, then
+   names_size bytes of '\0'-terminated names (host byte order).
+   Restore matches channels by name (unregistered ones are counted as
+   missing), skips read-only ones and writes the rest batched like
+   CdrSetSimpleChanVals(); in DIFF mode only those differing from live
+   values by more than tolerance.  Both return the # of channels
+   saved/written; refused writes don't fail the restore, but are
+   counted in *nfailed_p */
+#define CDR_SIMPLE_SNAP_MAGIC "CdrSSnp1"
+enum {CDR_SIMPLE_SNAP_VERSION = 1};
+
+enum
+{
+    CDR_SIMPLE_SNAP_ALL  = 0,
+    CDR_SIMPLE_SNAP_DIFF = 1,
+};
+
+typedef struct
+{
+    char      magic[8];     // CDR_SIMPLE_SNAP_MAGIC, no '\0'
+    uint32_t  version;
+    uint32_t  num_chans;
+    uint32_t  names_offset; // From the file start
+    uint32_t  names_size;
+    double    timestamp;    // Seconds since the Epoch
+} CdrSimpleSnapHeader_t;
+
+typedef struct
+{
+    double    value;
+    int32_t   rflags;
+    uint32_t  name_offset;  // From names_offset
+} CdrSimpleSnapEntry_t;
+
+int   CdrSaveSimpleSnapshot   (const char *path, const int *handles, int count);
+int   CdrRestoreSimpleSnapshot(const char *path, int mode, double tolerance,
+                               int *nmissing_p, int *nfailed_p);
 
 #ifdef __cplusplus
 }
@@ -3,7 +3,7 @@ import ctypes
 
 class ByteSegmentsArray:
     """
-    Array of int items with predefined length.
+    Array of int or float items with predefined length.
     Could be passed to any C function as void* (use AsCVoidPointer method)
     Will be deleted by python automatically
 
@@ -12,17 +12,22 @@ class ByteSegmentsArray:
     testlib.fill_buf.argtypes = [ctypes.c_int, int_p]
     testlib.fill_buf(50, buf.AsCVoidPointer())
     print buf.AsPythonList()
+    samples = buf.AsNumpyArray(50) # No copy, shares memory with buf
     """
     INT8 = 1
     INT16 = 2
     INT32 = 4
     INT64 = 8
+    FLOAT32 = 0x104 # Float types: 0x100 | item size
+    FLOAT64 = 0x108
+    _C_TYPES = {INT8: ctypes.c_int8, INT16: ctypes.c_int16, INT32: ctypes.c_int32, INT64: ctypes.c_int64,
+                FLOAT32: ctypes.c_float, FLOAT64: ctypes.c_double}
+    _FORMATS = {INT8: "b", INT16: "h", INT32: "i", INT64: "q", FLOAT32: "f", FLOAT64: "d"}
+    _NUMPY_DTYPES = {INT8: "=i1", INT16: "=i2", INT32: "=i4", INT64: "=i8", FLOAT32: "=f4", FLOAT64: "=f8"}
     def __init__(self, length, size=INT8):
-        self.data_type = None
-        if size==self.INT8: self.data_type = ctypes.c_int8
-        if size==self.INT16: self.data_type = ctypes.c_int16
-        if size==self.INT32: self.data_type = ctypes.c_int32
-        if size==self.INT64: self.data_type = ctypes.c_int64
+        if size not in self._C_TYPES: raise Exception("Unsupported ByteSegmentsArray item type: %s" % size)
+        self.data_type = self._C_TYPES[size]
+        self.size = size
         self.c_data = (self.data_type * length)()
         self.length = length
 
@@ -36,13 +41,32 @@ class ByteSegmentsArray:
         """
         Convert C data to python list, could use length and offset parameters.
         """
-        ### Performance: 2.5M items array converts during 1 second
-        ret = []
-        if length is None: length = self.length
-        for i in range(0, length):
-            val = int(self.c_data[i + offset])
-            if val is not None: ret+=[val]
-        return ret
+        ### Slicing is done by ctypes in C, no per-item Python code
+        if length is None: length = self.length - offset
+        return self.c_data[offset:offset + length]
+
+    def AsMemoryView(self, length=None, offset=0):
+        """
+        Returns memoryview of C data (no copy), could use length and offset parameters (in items).
+        """
+        if length is None: length = self.length - offset
+        view = memoryview(self.c_data)
+        # ctypes exports formats like "<h", which py3 can't index; recast to native ones
+        if hasattr(view, "cast"): view = view.cast("B").cast(self._FORMATS[self.size])
+        return view[offset:offset + length]
+
+    def AsNumpyArray(self, length=None, offset=0):
+        """
+        Returns NumPy array sharing memory with C data (no copy), could use length and offset parameters (in items).
+        The array keeps this object's storage alive.
+        """
+        import numpy
+        if length is None: length = self.length - offset
+        return numpy.frombuffer(self.c_data, dtype=self._NUMPY_DTYPES[self.size],
+                                count=length, offset=offset * ctypes.sizeof(self.data_type))
+
+    def __len__(self):
+        return self.length
 
     def __getitem__(self, item):
         """
@@ -52,12 +76,114 @@ class ByteSegmentsArray:
         print buf[i]
         """
         if type(item) != int or item>= self.length: return None
-        return int(self.c_data[item])
+        return self.c_data[item]
+
+class CdrSimpleUpdate(ctypes.Structure):
+    """
+    Mirror of C CdrSimpleUpdate_t, record of threaded-mode update queue
+    """
+    _fields_ = [("kind", ctypes.c_int),
+                ("handle", ctypes.c_int),
+                ("val", ctypes.c_double),
+                ("rflags", ctypes.c_int),
+                ("timestamp", ctypes.c_double)]
+
+HIST_SUB_BITS = 2
+HIST_SUB = 1 << HIST_SUB_BITS
+HIST_BUCKETS = (64 - HIST_SUB_BITS + 1) * HIST_SUB
+
+class CdrSimpleHist(ctypes.Structure):
+    """
+    Mirror of C CdrSimpleHist_t, log-linear histogram (see Cdr.h)
+    """
+    _fields_ = [("count", ctypes.c_uint64),
+                ("sum", ctypes.c_uint64),
+                ("min", ctypes.c_uint64),
+                ("max", ctypes.c_uint64),
+                ("buckets", ctypes.c_uint32 * HIST_BUCKETS)]
+
+    @staticmethod
+    def BucketLow(b):
+        """
+        Returns lowest value falling into bucket b
+        """
+        if b < 2 * HIST_SUB: return b
+        e = b // HIST_SUB + HIST_SUB_BITS - 1
+        return (HIST_SUB + b % HIST_SUB) << (e - HIST_SUB_BITS)
+
+    def Percentile(self, p):
+        """
+        Returns approximate p-th (0..100) percentile, 0 for empty histogram
+        """
+        if self.count == 0: return 0
+        need = self.count * p / 100.0
+        seen = 0
+        for b in range(HIST_BUCKETS):
+            seen += self.buckets[b]
+            if seen >= need and self.buckets[b] != 0: break
+        return min(max(self.BucketLow(b), self.min), self.max)
+
+    def AsDict(self):
+        return {"count": self.count,
+                "mean": float(self.sum) / self.count if self.count else 0.0,
+                "min": self.min, "max": self.max,
+                "p50": self.Percentile(50), "p90": self.Percentile(90), "p99": self.Percentile(99)}
+
+class CdrSimpleSubsysPerf(ctypes.Structure):
+    _fields_ = [("elapsed", ctypes.c_double),
+                ("events", ctypes.c_uint64),
+                ("process_time", CdrSimpleHist)]
+
+class CdrSimpleChanPerf(ctypes.Structure):
+    _fields_ = [("elapsed", ctypes.c_double),
+                ("callbacks", ctypes.c_uint64),
+                ("cb_time", CdrSimpleHist),
+                ("queue_delay", CdrSimpleHist)]
+
+class CdrSimpleBigcPerf(ctypes.Structure):
+    _fields_ = [("elapsed", ctypes.c_double),
+                ("events", ctypes.c_uint64),
+                ("callbacks", ctypes.c_uint64),
+                ("bytes_read", ctypes.c_uint64),
+                ("cb_time", CdrSimpleHist),
+                ("age", CdrSimpleHist)]
+
+class CdrSimpleBigcFrameStats(ctypes.Structure):
+    """
+    Per-frame statistics of bigc, see CdrWrapper.CdrSetSimpleBigcReduction()
+    """
+    _fields_ = [("generation", ctypes.c_int),
+                ("count", ctypes.c_int),
+                ("min", ctypes.c_double),
+                ("max", ctypes.c_double),
+                ("mean", ctypes.c_double),
+                ("rms", ctypes.c_double)]
 
 class CdrWrapper:
     """
     CDR Wrapper class ver0.2a, see use example below
     """
+    # Callback dispatch modes, see CdrSetSimpleChanDispatch()
+    DISPATCH_INHERIT = 0
+    DISPATCH_ALWAYS = 1
+    DISPATCH_ONCHANGE = 2
+    # Bigc frame ring policies, see CdrSetSimpleBigcRing()
+    RING_OVERWRITE_OLDEST = 0
+    RING_DROP_NEWEST = 1
+    # Subsystem processing modes
+    PROCESS_ALL = 0
+    PROCESS_REGISTERED = 1
+    # Kinds of threaded-mode update records
+    UPD_CHAN = 0
+    UPD_BIGC = 1
+    UPD_WRITE = 2
+    # Snapshot restore modes
+    SNAP_ALL = 0
+    SNAP_DIFF = 1
+    # Bigc reductions, see CdrSetSimpleBigcReduction()
+    REDUCE_STATS = 1
+    REDUCE_DECIMATE = 2
+
     def __init__(self, absolute_lib_path, opt_argv0=None):
         """
         Loads library
@@ -67,6 +193,77 @@ class CdrWrapper:
         if (not opt_argv0): opt_argv0 = sys.argv[0]
         self.library = ctypes.CDLL(absolute_lib_path)
         self.argv0 = opt_argv0
+        self._DeclarePrototypes()
+
+    def _DeclarePrototypes(self):
+        """
+        Declares restype/argtypes of library functions once, instead of on every call
+        """
+        c_int_p = ctypes.POINTER(ctypes.c_int)
+        c_double_p = ctypes.POINTER(ctypes.c_double)
+        c_char_pp = ctypes.POINTER(ctypes.c_char_p)
+        c_void_pp = ctypes.POINTER(ctypes.c_void_p)
+        for name, restype, argtypes in [
+            ("CdrRegisterSimpleChan", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_void_p, ctypes.c_void_p]),
+            ("CdrRegisterSimpleChans", ctypes.c_int, [c_char_pp, ctypes.c_int, ctypes.c_char_p, ctypes.c_void_p, c_void_pp, c_int_p, c_int_p]),
+            ("CdrSetSimpleChanVal", ctypes.c_int, [ctypes.c_int, ctypes.c_double]),
+            ("CdrGetSimpleChanVal", ctypes.c_int, [ctypes.c_int, c_double_p]),
+            ("CdrGetSimpleChanVals", ctypes.c_int, [c_int_p, ctypes.c_int, c_double_p, c_int_p]),
+            ("CdrSetSimpleChanVals", ctypes.c_int, [c_int_p, c_double_p, ctypes.c_int]),
+            ("CdrSetSimpleChanDispatch", ctypes.c_int, [ctypes.c_int, ctypes.c_int]),
+            ("CdrSetSimpleSubsysDispatch", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]),
+            ("CdrSimplePreloadSubsystems", ctypes.c_int, [c_char_pp, ctypes.c_int, ctypes.c_char_p, c_int_p]),
+            ("CdrUnregisterSimpleChan", ctypes.c_int, [ctypes.c_int]),
+            ("CdrSetSimpleChanValAsync", ctypes.c_int, [ctypes.c_int, ctypes.c_double]),
+            ("CdrFlushSimpleWrites", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p]),
+            ("CdrSetSimpleWriteCB", ctypes.c_int, [ctypes.c_void_p, ctypes.c_void_p]),
+            ("CdrUnregisterSimpleBigc", ctypes.c_int, [ctypes.c_int]),
+            ("CdrActivateSimpleChanHistory", ctypes.c_int, [ctypes.c_int, ctypes.c_int]),
+            ("CdrGetSimpleChanHistory", ctypes.c_int, [ctypes.c_int, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int]),
+            ("CdrSetSimpleChanFilter", ctypes.c_int, [ctypes.c_int, ctypes.c_double, ctypes.c_double, ctypes.c_double]),
+            ("CdrGetSimpleChanFilterStats", ctypes.c_int, [ctypes.c_int, ctypes.POINTER(ctypes.c_uint), ctypes.POINTER(ctypes.c_uint)]),
+            ("CdrSetSimpleSubsysCycleCB", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_void_p, ctypes.c_void_p]),
+            ("CdrSetSimpleSubsysProcessing", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]),
+            ("CdrSetSimpleSubsysLocalRegs", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int]),
+            ("CdrAddSimpleSubsysDependency", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_char_p]),
+            ("CdrRegisterSimpleBigc", ctypes.c_int, [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_void_p, ctypes.c_void_p]),
+            ("CdrRegisterSimpleBigcs", ctypes.c_int, [c_char_pp, ctypes.c_int, ctypes.c_char_p, ctypes.c_size_t, ctypes.c_void_p, c_void_pp, c_int_p, c_int_p]),
+            ("CdrAcquireSimpleBigcView", ctypes.c_int, [ctypes.c_int, c_void_pp, ctypes.POINTER(ctypes.c_size_t), c_int_p]),
+            ("CdrReleaseSimpleBigcView", ctypes.c_int, [ctypes.c_int]),
+            ("CdrSetSimpleBigcRing", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+            ("CdrPopSimpleBigcFrame", ctypes.c_int, [ctypes.c_int, ctypes.c_void_p, ctypes.c_size_t, ctypes.POINTER(ctypes.c_size_t), c_int_p, c_int_p]),
+            ("CdrGetSimpleBigcRingStats", ctypes.c_int, [ctypes.c_int, c_int_p, ctypes.POINTER(ctypes.c_uint), ctypes.POINTER(ctypes.c_uint)]),
+            ("CdrGetSimpleBigcParam", ctypes.c_int, [ctypes.c_int, ctypes.c_int, c_int_p]),
+            ("CdrSetSimpleBigcParam", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+            ("CdrGetSimpleBigcParams", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int, c_int_p]),
+            ("CdrSetSimpleBigcParams", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int, c_int_p]),
+            ("CdrSetSimpleBigcScale", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_double, ctypes.c_double]),
+            ("CdrGetSimpleBigcFloats", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_void_p]),
+            ("CdrGetSimpleBigcDoubles", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int, ctypes.c_void_p]),
+            ("CdrSimpleBigcDecodeKernel", ctypes.c_char_p, []),
+            ("CdrSetSimpleBigcReduction", ctypes.c_int, [ctypes.c_int, ctypes.c_int, ctypes.c_int]),
+            ("CdrGetSimpleBigcFrameStats", ctypes.c_int, [ctypes.c_int, ctypes.POINTER(CdrSimpleBigcFrameStats)]),
+            ("CdrGetSimpleBigcDecimated", ctypes.c_int, [ctypes.c_int, ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int, c_int_p]),
+            ("CdrSimpleStartThread", ctypes.c_int, [ctypes.c_int]),
+            ("CdrSimpleStopThread", ctypes.c_int, []),
+            ("CdrSimpleQueueFd", ctypes.c_int, []),
+            ("CdrSimpleDrainQueue", ctypes.c_int, [ctypes.POINTER(CdrSimpleUpdate), ctypes.c_int]),
+            ("CdrSimpleGetQueueStats", ctypes.c_int, [ctypes.POINTER(ctypes.c_uint), ctypes.POINTER(ctypes.c_uint)]),
+            ("CdrSimpleProcessPending", ctypes.c_int, [ctypes.c_int]),
+            ("CdrSimpleEnablePerf", ctypes.c_int, [ctypes.c_int]),
+            ("CdrSimpleResetPerf", ctypes.c_int, []),
+            ("CdrGetSimpleSubsysPerf", ctypes.c_int, [ctypes.c_char_p, ctypes.POINTER(CdrSimpleSubsysPerf)]),
+            ("CdrGetSimpleChanPerf", ctypes.c_int, [ctypes.c_int, ctypes.POINTER(CdrSimpleChanPerf)]),
+            ("CdrGetSimpleBigcPerf", ctypes.c_int, [ctypes.c_int, ctypes.POINTER(CdrSimpleBigcPerf)]),
+            ("CdrOpenSimpleLog", ctypes.c_int, [ctypes.c_char_p, c_int_p, ctypes.c_int, ctypes.c_size_t, ctypes.c_double]),
+            ("CdrCloseSimpleLog", ctypes.c_int, [ctypes.c_int]),
+            ("CdrGetSimpleLogStats", ctypes.c_int, [ctypes.c_int, ctypes.POINTER(ctypes.c_uint64), ctypes.POINTER(ctypes.c_uint64)]),
+            ("CdrSaveSimpleSnapshot", ctypes.c_int, [ctypes.c_char_p, c_int_p, ctypes.c_int]),
+            ("CdrRestoreSimpleSnapshot", ctypes.c_int, [ctypes.c_char_p, ctypes.c_int, ctypes.c_double, c_int_p, c_int_p]),
+            ]:
+            func = getattr(self.library, name)
+            func.restype = restype
+            func.argtypes = argtypes
     
     def MakeCdrChanCallback(self, python_callable):
         """
@@ -88,35 +285,259 @@ class CdrWrapper:
         """
         Registers cdr callback by specified name event(???), with optional private params
         """
-        self.library.CdrRegisterSimpleChan.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_void_p, ctypes.c_void_p]
         ret = self.library.CdrRegisterSimpleChan(name, self.argv0, cdr_callback, pivate_params)
         if (ret < 0): raise Exception("Error while Registering Simple Channel Callback, errcode: %s" % ret)
         return ret
 
+    def _RegisterBatch(self, func, names, extra_args, cdr_callback, pivate_params):
+        count = len(names)
+        c_names = (ctypes.c_char_p * count)(*names)
+        c_privs = None
+        if pivate_params is not None: c_privs = (ctypes.c_void_p * count)(*pivate_params)
+        handles = (ctypes.c_int * count)()
+        errs = (ctypes.c_int * count)()
+        args = [c_names, count, self.argv0] + extra_args + [cdr_callback, c_privs, handles, errs]
+        ret = func(*args)
+        if (ret < 0): raise Exception("Error while Registering Simple Channels batch, errcode: %s" % ret)
+        return list(handles), list(errs)
+
+    def CdrRegisterSimpleChans(self, names, cdr_callback, pivate_params=None):
+        """
+        Registers a batch of channels with one callback in one library call
+        names - list of channel names
+        pivate_params - optional list of private params, one per name
+        Returns (handles, errcodes) lists: handle is -1 and errcode is errno value for failed names
+        """
+        return self._RegisterBatch(self.library.CdrRegisterSimpleChans, names, [],
+                                   cdr_callback, pivate_params)
+
+    def CdrSimplePreloadSubsystems(self, subsystems):
+        """
+        Loads subsystems in advance, one by one, in a single call
+        subsystems - list of subsystem names
+        Returns (loaded_count, errcodes) where errcode is errno value for failed names
+        """
+        count = len(subsystems)
+        c_names = (ctypes.c_char_p * count)(*subsystems)
+        errs = (ctypes.c_int * count)()
+        ret = self.library.CdrSimplePreloadSubsystems(c_names, count, self.argv0, errs)
+        if (ret < 0): raise Exception("Error while Preloading Simple Subsystems, errcode: %s" % ret)
+        return ret, list(errs)
+
+    def CdrUnregisterSimpleChan(self, handle):
+        """
+        Unregisters Simple Channel; subsystem is unloaded when its last channel goes
+        (may be called from callbacks, release is then done after the dispatch)
+        """
+        ret = self.library.CdrUnregisterSimpleChan(handle)
+        if (ret != 0): raise Exception("Error while Unregistering Simple Channel, errcode: %s" % ret)
+        return ret
+
     def CdrSetSimpleChanVal(self, handle, val):
         """
         Sets Simple Channel Value by handle
         handle - int, id of the channel
         val - double, value to set
         """
-        self.library.CdrSetSimpleChanVal.restype = ctypes.c_int
-        self.library.CdrSetSimpleChanVal.argtypes = [ctypes.c_int, ctypes.c_double]
         ret = self.library.CdrSetSimpleChanVal(handle, val)
         if (ret != 0): raise Exception("Error while Setting Simple Channel Value, errcode: %s" % ret)
         return ret
 
+    def CdrSetSimpleChanValAsync(self, handle, val):
+        """
+        Queues Simple Channel Value write, without blocking; only the last queued value per channel
+        is written, in one batch per subsystem after its server cycle (or on CdrFlushSimpleWrites)
+        """
+        ret = self.library.CdrSetSimpleChanValAsync(handle, val)
+        if (ret != 0): raise Exception("Error while Setting Simple Channel Value Async, errcode: %s" % ret)
+        return ret
+
+    def CdrFlushSimpleWrites(self, subsys=None):
+        """
+        Writes pending async values now; subsys - string, or None for all subsystems
+        """
+        ret = self.library.CdrFlushSimpleWrites(subsys, self.argv0)
+        if (ret != 0): raise Exception("Error while Flushing Simple Writes, errcode: %s" % ret)
+        return ret
+
+    def MakeCdrWriteCallback(self, python_callable):
+        """
+        Returns async write completion callback from python callable function.
+        python_callable - function that takes handle(integer), value(double), err(integer, 0 or errno), private_params(object)
+        """
+        CB_FUNC = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.c_double, ctypes.c_int, ctypes.c_void_p)
+        return CB_FUNC(python_callable)
+
+    def CdrSetSimpleWriteCB(self, write_callback, pivate_params=None):
+        """
+        Sets async write completion callback (made by MakeCdrWriteCallback), None to remove
+        """
+        ret = self.library.CdrSetSimpleWriteCB(write_callback, pivate_params)
+        if (ret != 0): raise Exception("Error while Setting Simple Write Callback, errcode: %s" % ret)
+        return ret
+
     def CdrGetSimpleChanVal(self, handle):
         """
         Returns Simple Channel Value, gotten by handle
         handle - int, id of the channel
         """
-        self.library.CdrSetSimpleChanVal.restype = ctypes.c_int
-        self.library.CdrSetSimpleChanVal.argtypes = [ctypes.c_int, ctypes.POINTER(ctypes.c_double)]
         val = ctypes.c_double(0.0)
         ret = self.library.CdrGetSimpleChanVal(handle, ctypes.byref(val))
         if (ret != 0): raise Exception("Error while Getting Simple Channel Value, errcode: %s" % ret)
         return val.value
 
+    def CdrGetSimpleChanVals(self, handles):
+        """
+        Returns (values, rflags) lists of many Simple Channels, gotten in one call
+        handles - list of channel ids
+        """
+        count = len(handles)
+        c_handles = (ctypes.c_int * count)(*handles)
+        vals = (ctypes.c_double * count)()
+        rflags = (ctypes.c_int * count)()
+        ret = self.library.CdrGetSimpleChanVals(c_handles, count, vals, rflags)
+        if (ret != 0): raise Exception("Error while Getting Simple Channel Values, errcode: %s" % ret)
+        return vals[:], rflags[:]
+
+    def CdrSetSimpleChanVals(self, handles, vals):
+        """
+        Sets values of many Simple Channels in one call
+        handles - list of channel ids
+        vals - list of doubles, same length as handles
+        """
+        count = len(handles)
+        if len(vals) != count: raise Exception("handles and vals lengths differ")
+        c_handles = (ctypes.c_int * count)(*handles)
+        c_vals = (ctypes.c_double * count)(*vals)
+        ret = self.library.CdrSetSimpleChanVals(c_handles, c_vals, count)
+        if (ret != 0): raise Exception("Error while Setting Simple Channel Values, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleChanDispatch(self, handle, mode):
+        """
+        Sets callback dispatch mode of Simple Channel
+        handle - int, id of the channel
+        mode - DISPATCH_ONCHANGE to be called only when value or rflags change,
+               DISPATCH_ALWAYS to be called on every server cycle,
+               DISPATCH_INHERIT to use subsystem's mode
+        """
+        ret = self.library.CdrSetSimpleChanDispatch(handle, mode)
+        if (ret != 0): raise Exception("Error while Setting Simple Channel Dispatch, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleSubsysDispatch(self, subsys, mode):
+        """
+        Sets default callback dispatch mode for all channels of subsystem
+        subsys - string, subsystem name (loaded if not yet)
+        mode - DISPATCH_ONCHANGE or DISPATCH_ALWAYS
+        """
+        ret = self.library.CdrSetSimpleSubsysDispatch(subsys, self.argv0, mode)
+        if (ret != 0): raise Exception("Error while Setting Simple Subsys Dispatch, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleSubsysProcessing(self, subsys, mode):
+        """
+        Sets what is evaluated each cycle: PROCESS_ALL knobs of subsystem, or PROCESS_REGISTERED --
+        only registered channels plus writers of local registers they read (found from formulas)
+        """
+        ret = self.library.CdrSetSimpleSubsysProcessing(subsys, self.argv0, mode)
+        if (ret != 0): raise Exception("Error while Setting Simple Subsys Processing, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleSubsysLocalRegs(self, subsys, count):
+        """
+        Sets number of local registers of subsystem (by default sized from its formulas), values of kept ones are preserved
+        """
+        ret = self.library.CdrSetSimpleSubsysLocalRegs(subsys, self.argv0, count)
+        if (ret != 0): raise Exception("Error while Setting Simple Subsys Local Regs, errcode: %s" % ret)
+        return ret
+
+    def CdrAddSimpleSubsysDependency(self, subsys, knobname):
+        """
+        Adds knob to be evaluated in PROCESS_REGISTERED mode, for dependencies not seen in formulas
+        knobname - string, knob name inside subsystem (without "subsys." prefix)
+        """
+        ret = self.library.CdrAddSimpleSubsysDependency(subsys, self.argv0, knobname)
+        if (ret != 0): raise Exception("Error while Adding Simple Subsys Dependency, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleChanFilter(self, handle, max_rate=0, deadband_abs=0, deadband_rel=0):
+        """
+        Sets Simple Channel filtering, done in C before callbacks (0 disables a check)
+        handle - int, id of the channel
+        max_rate - float, max callbacks per second, coalesced to the latest value
+        deadband_abs, deadband_rel - float, changes within max(abs, rel*|last delivered|) are dropped
+        """
+        ret = self.library.CdrSetSimpleChanFilter(handle, max_rate, deadband_abs, deadband_rel)
+        if (ret != 0): raise Exception("Error while Setting Simple Channel Filter, errcode: %s" % ret)
+        return ret
+
+    def CdrGetSimpleChanFilterStats(self, handle):
+        """
+        Returns (delivered, suppressed) update counters of Simple Channel
+        """
+        delivered = ctypes.c_uint(0)
+        suppressed = ctypes.c_uint(0)
+        ret = self.library.CdrGetSimpleChanFilterStats(handle, ctypes.byref(delivered), ctypes.byref(suppressed))
+        if (ret != 0): raise Exception("Error while Getting Simple Channel Filter Stats, errcode: %s" % ret)
+        return delivered.value, suppressed.value
+
+    def CdrActivateSimpleChanHistory(self, handle, size):
+        """
+        Keeps last size values of Simple Channel (one per server cycle) with timestamps; 0 turns history off
+        """
+        ret = self.library.CdrActivateSimpleChanHistory(handle, size)
+        if (ret != 0): raise Exception("Error while Activating Simple Channel History, errcode: %s" % ret)
+        return ret
+
+    def CdrGetSimpleChanHistory(self, handle, max_points):
+        """
+        Returns (values, timestamps) of up to max_points newest history points, oldest first.
+        Arrays are NumPy float64 arrays if NumPy is available, else lists
+        """
+        vals = ByteSegmentsArray(max_points, ByteSegmentsArray.FLOAT64)
+        times = ByteSegmentsArray(max_points, ByteSegmentsArray.FLOAT64)
+        ret = self.library.CdrGetSimpleChanHistory(handle, vals.AsCVoidPointer(), times.AsCVoidPointer(), max_points)
+        if (ret < 0): raise Exception("Error while Getting Simple Channel History, errcode: %s" % ret)
+        try:
+            return vals.AsNumpyArray(ret), times.AsNumpyArray(ret)
+        except ImportError:
+            return vals.AsPythonList(ret), times.AsPythonList(ret)
+
+    def MakeCdrCycleCallback(self, python_callable):
+        """
+        Returns cdr cycle callback from python callable function.
+        python_callable - function that takes handles, values, rflags (parallel arrays of channels
+        updated in a server cycle) and private_params(object)
+        Arrays are NumPy views of library buffers if NumPy is available (valid during the call only,
+        copy them to keep), else lists
+
+        EXAMPLE:
+            def test_cycle_cb_py(handles, vals, rflags, params):
+                print "Python Cycle Callback:", len(handles), "channels updated"
+        """
+        try:
+            import numpy.ctypeslib
+            def as_array(ptr, count): return numpy.ctypeslib.as_array(ptr, shape=(count,))
+        except ImportError:
+            def as_array(ptr, count): return ptr[:count]
+        def cycle_cb(count, handles, vals, rflags, params):
+            if count <= 0: return
+            python_callable(as_array(handles, count), as_array(vals, count), as_array(rflags, count), params)
+        CB_FUNC = ctypes.CFUNCTYPE(None, ctypes.c_int, ctypes.POINTER(ctypes.c_int),
+                                   ctypes.POINTER(ctypes.c_double), ctypes.POINTER(ctypes.c_int), ctypes.c_void_p)
+        ret = CB_FUNC(cycle_cb)
+        return ret
+
+    def CdrSetSimpleSubsysCycleCB(self, subsys, cdr_callback, pivate_params=None):
+        """
+        Sets cycle callback (see MakeCdrCycleCallback()) of subsystem, None removes it
+        subsys - string, subsystem name (loaded if not yet)
+        """
+        ret = self.library.CdrSetSimpleSubsysCycleCB(subsys, self.argv0, cdr_callback, pivate_params)
+        if (ret != 0): raise Exception("Error while Setting Simple Subsys Cycle Callback, errcode: %s" % ret)
+        return ret
+
 #############################################
     def MakeCdrBigcCallback(self, python_callable):
         """
@@ -138,22 +559,94 @@ class CdrWrapper:
         """
         Registers cdr callback by specified name event(???), with optional private params
         """
-        self.library.CdrRegisterSimpleBigc.argtypes = [ctypes.c_char_p, ctypes.c_char_p, ctypes.c_int, ctypes.c_void_p, ctypes.c_void_p]
-        ret = self.library.CdrRegisterSimpleChan(name, self.argv0, max_datasize, cdr_callback, pivate_params)
+        ret = self.library.CdrRegisterSimpleBigc(name, self.argv0, max_datasize, cdr_callback, pivate_params)
         if (ret < 0): raise Exception("Error while Registering Simple BigChan Callback, errcode: %s" % ret)
         return ret
 
+    def CdrRegisterSimpleBigcs(self, names, max_datasize, cdr_callback, pivate_params=None):
+        """
+        Registers a batch of big channels with one callback in one library call
+        Returns (handles, errcodes) lists, see CdrRegisterSimpleChans()
+        """
+        return self._RegisterBatch(self.library.CdrRegisterSimpleBigcs, names, [max_datasize],
+                                   cdr_callback, pivate_params)
+
+    def CdrUnregisterSimpleBigc(self, handle):
+        """
+        Unregisters Simple Bigc; its server connection and subsystem are released with their last user
+        Fails while a view acquired by CdrAcquireSimpleBigcView() is held
+        """
+        ret = self.library.CdrUnregisterSimpleBigc(handle)
+        if (ret != 0): raise Exception("Error while Unregistering Simple BigChan, errcode: %s" % ret)
+        return ret
+
+    def CdrAcquireSimpleBigcView(self, handle):
+        """
+        Returns (memoryview, generation) of current Simple Bigc data, without copying
+        handle - int, id of the bigc
+        The memoryview must be treated as read-only and stays valid until CdrReleaseSimpleBigcView()
+        """
+        ptr = ctypes.c_void_p()
+        size = ctypes.c_size_t(0)
+        gen = ctypes.c_int(0)
+        ret = self.library.CdrAcquireSimpleBigcView(handle, ctypes.byref(ptr), ctypes.byref(size), ctypes.byref(gen))
+        if (ret != 0): raise Exception("Error while Acquiring Simple BigChan View, errcode: %s" % ret)
+        if size.value == 0: return memoryview(b""), gen.value
+        view = memoryview((ctypes.c_uint8 * size.value).from_address(ptr.value))
+        if hasattr(view, "cast"): view = view.cast("B") # ctypes gives "<B" format, which py3 can't index
+        return view, gen.value
+
+    def CdrReleaseSimpleBigcView(self, handle):
+        """
+        Releases view gotten by CdrAcquireSimpleBigcView(); the memoryview must not be used afterwards
+        """
+        ret = self.library.CdrReleaseSimpleBigcView(handle)
+        if (ret != 0): raise Exception("Error while Releasing Simple BigChan View, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleBigcRing(self, handle, nframes, policy=RING_OVERWRITE_OLDEST):
+        """
+        Sets up ring of nframes preallocated frames for Simple Bigc (0 disables it)
+        policy - RING_OVERWRITE_OLDEST or RING_DROP_NEWEST, what to do when ring is full
+        """
+        ret = self.library.CdrSetSimpleBigcRing(handle, nframes, policy)
+        if (ret != 0): raise Exception("Error while Setting Simple BigChan Ring, errcode: %s" % ret)
+        return ret
+
+    def CdrPopSimpleBigcFrame(self, handle, buf):
+        """
+        Takes oldest frame from Simple Bigc ring into buf (ByteSegmentsArray)
+        Returns None if ring is empty, else (size_in_bytes, tag, rflags)
+        """
+        size = ctypes.c_size_t(0)
+        tag = ctypes.c_int(0)
+        rflags = ctypes.c_int(0)
+        ret = self.library.CdrPopSimpleBigcFrame(handle, buf.AsCVoidPointer(), ctypes.sizeof(buf.c_data),
+                                                 ctypes.byref(size), ctypes.byref(tag), ctypes.byref(rflags))
+        if (ret < 0): raise Exception("Error while Popping Simple BigChan Frame, errcode: %s" % ret)
+        if (ret == 0): return None
+        return size.value, tag.value, rflags.value
+
+    def CdrGetSimpleBigcRingStats(self, handle):
+        """
+        Returns (frames_queued, frames_pushed, frames_dropped) of Simple Bigc ring
+        """
+        used = ctypes.c_int(0)
+        pushed = ctypes.c_uint(0)
+        dropped = ctypes.c_uint(0)
+        ret = self.library.CdrGetSimpleBigcRingStats(handle, ctypes.byref(used), ctypes.byref(pushed), ctypes.byref(dropped))
+        if (ret != 0): raise Exception("Error while Getting Simple BigChan Ring Stats, errcode: %s" % ret)
+        return used.value, pushed.value, dropped.value
+
     def CdrSetSimpleBigcParam(self, handle, n, val):
         """
         Sets Simple Bigc Param by handle
         handle - int, id of the bigc
         n - int, # of parameter to set
-        val - double, value to set
+        val - int, value to set
         """
-        self.library.CdrSetSimpleBigcParam.restype = ctypes.c_int
-        self.library.CdrSetSimpleBigcParam.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.c_int]
         ret = self.library.CdrSetSimpleBigcParam(handle, n, val)
-        if (ret != 0): raise Exception("Error while Setting Simple BigChan Param, errcode: %s" % ret)
+        if (ret < 0): raise Exception("Error while Setting Simple BigChan Param, errcode: %s" % ret)
         return ret
 
     def CdrGetSimpleBigcParam(self, handle, n):
@@ -162,13 +655,464 @@ class CdrWrapper:
         handle - int, id of the bigc
         n - int, # of parameter to get
         """
-        self.library.CdrSetSimpleBigcParam.restype = ctypes.c_int
-        self.library.CdrSetSimpleBigcParam.argtypes = [ctypes.c_int, ctypes.c_int, ctypes.POINTER(ctypes.c_double)]
-        val = ctypes.c_double(0.0)
+        val = ctypes.c_int(0)
         ret = self.library.CdrGetSimpleBigcParam(handle, n, ctypes.byref(val))
-        if (ret != 0): raise Exception("Error while Getting Simple BigChan Param, errcode: %s" % ret)
+        if (ret < 0): raise Exception("Error while Getting Simple BigChan Param, errcode: %s" % ret)
         return val.value
 
+    def CdrGetSimpleBigcParams(self, handle, start, count):
+        """
+        Returns list of count Simple Bigc Params starting from #start, gotten in one request
+        handle - int, id of the bigc
+        """
+        vals = (ctypes.c_int * count)()
+        ret = self.library.CdrGetSimpleBigcParams(handle, start, count, vals)
+        if (ret < 0): raise Exception("Error while Getting Simple BigChan Params, errcode: %s" % ret)
+        return vals[:]
+
+    def CdrSetSimpleBigcParams(self, handle, start, vals):
+        """
+        Sets Simple Bigc Params #start...#start+len(vals)-1 in one request
+        handle - int, id of the bigc
+        vals - list (or any sequence) of ints
+        """
+        count = len(vals)
+        c_vals = (ctypes.c_int * count)(*vals)
+        ret = self.library.CdrSetSimpleBigcParams(handle, start, count, c_vals)
+        if (ret < 0): raise Exception("Error while Setting Simple BigChan Params, errcode: %s" % ret)
+        return ret
+
+    def CdrSetSimpleBigcScale(self, handle, dataunits=4, r=1.0, d=0.0):
+        """
+        Sets sample size (1, 2 or 4 bytes, signed) and physical scaling phys=raw/r-d of Simple Bigc,
+        used by CdrGetSimpleBigcDecoded()
+        """
+        ret = self.library.CdrSetSimpleBigcScale(handle, dataunits, r, d)
+        if (ret != 0): raise Exception("Error while Setting Simple BigChan Scale, errcode: %s" % ret)
+        return ret
+
+    def CdrGetSimpleBigcDecoded(self, handle, first=0, count=None, double=False):
+        """
+        Returns samples [first, first+count) of Simple Bigc (None - up to the frame end) in physical units,
+        converted in C by SIMD kernel: NumPy float32 (float64 if double) array if NumPy is available, else list
+        """
+        if double:
+            func, item = self.library.CdrGetSimpleBigcDoubles, ByteSegmentsArray.FLOAT64
+        else:
+            func, item = self.library.CdrGetSimpleBigcFloats, ByteSegmentsArray.FLOAT32
+        if count is None:
+            count = func(handle, first, 0x7fffffff, None)
+            if (count < 0): raise Exception("Error while Getting Simple BigChan Decoded Data, errcode: %s" % count)
+        buf = ByteSegmentsArray(count, item)
+        ret = func(handle, first, count, buf.AsCVoidPointer())
+        if (ret < 0): raise Exception("Error while Getting Simple BigChan Decoded Data, errcode: %s" % ret)
+        try:
+            return buf.AsNumpyArray(ret)
+        except ImportError:
+            return buf.AsPythonList(ret)
+
+    def CdrSimpleBigcDecodeKernel(self):
+        """
+        Returns name of the decoding kernel in use: "avx2", "sse4.1", "neon" or "portable"
+        """
+        return self.library.CdrSimpleBigcDecodeKernel().decode()
+
+    def CdrSetSimpleBigcReduction(self, handle, stats=True, decim_points=0):
+        """
+        Makes library reduce every arriving frame of Simple Bigc (in physical units, see CdrSetSimpleBigcScale()):
+        stats - min/max/mean/rms of the frame, for CdrGetSimpleBigcFrameStats()
+        decim_points - >0: min/max of that many equal buckets, for CdrGetSimpleBigcDecimated()
+        """
+        flags = (self.REDUCE_STATS if stats else 0) | (self.REDUCE_DECIMATE if decim_points > 0 else 0)
+        ret = self.library.CdrSetSimpleBigcReduction(handle, flags, decim_points)
+        if (ret != 0): raise Exception("Error while Setting Simple BigChan Reduction, errcode: %s" % ret)
+        return ret
+
+    def CdrGetSimpleBigcFrameStats(self, handle):
+        """
+        Returns dict of the last frame statistics: generation, count, min, max, mean, rms
+        """
+        stats = CdrSimpleBigcFrameStats()
+        ret = self.library.CdrGetSimpleBigcFrameStats(handle, ctypes.byref(stats))
+        if (ret != 0): raise Exception("Error while Getting Simple BigChan Frame Stats, errcode: %s" % ret)
+        return dict((name, getattr(stats, name)) for name, _ in stats._fields_)
+
+    def CdrGetSimpleBigcDecimated(self, handle, max_points):
+        """
+        Returns (mins, maxs, generation) of the last frame's decimation buckets.
+        Arrays are NumPy float64 arrays if NumPy is available, else lists
+        """
+        mins = ByteSegmentsArray(max_points, ByteSegmentsArray.FLOAT64)
+        maxs = ByteSegmentsArray(max_points, ByteSegmentsArray.FLOAT64)
+        gen = ctypes.c_int(0)
+        ret = self.library.CdrGetSimpleBigcDecimated(handle, mins.AsCVoidPointer(), maxs.AsCVoidPointer(),
+                                                     max_points, ctypes.byref(gen))
+        if (ret < 0): raise Exception("Error while Getting Simple BigChan Decimated Data, errcode: %s" % ret)
+        try:
+            return mins.AsNumpyArray(ret), maxs.AsNumpyArray(ret), gen.value
+        except ImportError:
+            return mins.AsPythonList(ret), maxs.AsPythonList(ret), gen.value
+
+#############################################
+    def CdrSimpleStartThread(self, queue_size=0):
+        """
+        Starts threaded mode: library runs cda event loop in its own thread (no Qt main loop needed)
+        and puts updates into a queue instead of calling callbacks
+        queue_size - max records in queue, 0 for default
+        """
+        ret = self.library.CdrSimpleStartThread(queue_size)
+        if (ret != 0): raise Exception("Error while Starting Simple Thread, errcode: %s" % ret)
+        return ret
+
+    def CdrSimpleStopThread(self):
+        """
+        Stops threaded mode event thread
+        """
+        return self.library.CdrSimpleStopThread()
+
+    def CdrSimpleQueueFd(self):
+        """
+        Returns file descriptor which becomes readable when update records arrive (for select/poll)
+        """
+        return self.library.CdrSimpleQueueFd()
+
+    def CdrSimpleDrainQueue(self, max_records=1024):
+        """
+        Returns list of (kind, handle, val, rflags, timestamp) update records, up to max_records
+        kind - UPD_CHAN or UPD_BIGC (for bigcs val is frame generation)
+        """
+        if getattr(self, "_drain_buf", None) is None or len(self._drain_buf) < max_records:
+            self._drain_buf = (CdrSimpleUpdate * max_records)()
+        n = self.library.CdrSimpleDrainQueue(self._drain_buf, max_records)
+        if (n < 0): raise Exception("Error while Draining Simple Queue, errcode: %s" % n)
+        return [(u.kind, u.handle, u.val, u.rflags, u.timestamp) for u in self._drain_buf[:n]]
+
+    def CdrSimpleGetQueueStats(self):
+        """
+        Returns (records_pushed, records_dropped) of threaded-mode update queue
+        """
+        pushed = ctypes.c_uint(0)
+        dropped = ctypes.c_uint(0)
+        self.library.CdrSimpleGetQueueStats(ctypes.byref(pushed), ctypes.byref(dropped))
+        return pushed.value, dropped.value
+
+    def CdrSimpleProcessPending(self, max_events=0):
+        """
+        Calls callbacks of queued updates in the calling thread; call it when CdrSimpleQueueFd() is readable
+        max_events - max records to process, 0 for all pending
+        Returns number of processed records
+        """
+        ret = self.library.CdrSimpleProcessPending(max_events)
+        if (ret < 0): raise Exception("Error while Processing Simple Pending Events, errcode: %s" % ret)
+        return ret
+
+#############################################
+    def CdrSimpleEnablePerf(self, on=True):
+        """
+        Enables/disables instrumentation (counters and latency histograms)
+        """
+        return self.library.CdrSimpleEnablePerf(1 if on else 0)
+
+    def CdrSimpleResetPerf(self):
+        """
+        Zeroes all instrumentation data
+        """
+        return self.library.CdrSimpleResetPerf()
+
+    def CdrGetSimplePerf(self, subsystems=(), chans=(), bigcs=()):
+        """
+        Returns instrumentation snapshot as dict:
+        {"subsystems": {name: {...}}, "chans": {handle: {...}}, "bigcs": {handle: {...}}}
+        Rates are per second since enabling/reset; times are in ns, histograms are dicts
+        with count, mean, min, max, p50, p90, p99
+        """
+        result = {"subsystems": {}, "chans": {}, "bigcs": {}}
+        for name in subsystems:
+            perf = CdrSimpleSubsysPerf()
+            ret = self.library.CdrGetSimpleSubsysPerf(name, ctypes.byref(perf))
+            if (ret != 0): raise Exception("Error while Getting Simple Subsys Perf, errcode: %s" % ret)
+            result["subsystems"][name] = {
+                "events": perf.events,
+                "event_rate": perf.events / perf.elapsed if perf.elapsed > 0 else 0.0,
+                "process_time": perf.process_time.AsDict()}
+        for handle in chans:
+            perf = CdrSimpleChanPerf()
+            ret = self.library.CdrGetSimpleChanPerf(handle, ctypes.byref(perf))
+            if (ret != 0): raise Exception("Error while Getting Simple Channel Perf, errcode: %s" % ret)
+            result["chans"][handle] = {
+                "callbacks": perf.callbacks,
+                "callback_rate": perf.callbacks / perf.elapsed if perf.elapsed > 0 else 0.0,
+                "cb_time": perf.cb_time.AsDict(),
+                "queue_delay": perf.queue_delay.AsDict()}
+        for handle in bigcs:
+            perf = CdrSimpleBigcPerf()
+            ret = self.library.CdrGetSimpleBigcPerf(handle, ctypes.byref(perf))
+            if (ret != 0): raise Exception("Error while Getting Simple BigChan Perf, errcode: %s" % ret)
+            result["bigcs"][handle] = {
+                "events": perf.events,
+                "event_rate": perf.events / perf.elapsed if perf.elapsed > 0 else 0.0,
+                "callbacks": perf.callbacks,
+                "bytes_read": perf.bytes_read,
+                "byte_rate": perf.bytes_read / perf.elapsed if perf.elapsed > 0 else 0.0,
+                "cb_time": perf.cb_time.AsDict(),
+                "age": perf.age.AsDict()}
+        return result
+
+    def CdrOpenSimpleLog(self, filename, handles, rotate_size=0, fsync_interval=1.0):
+        """
+        Starts binary logging of Simple Channels (a record per channel per server cycle), returns log id.
+        rotate_size - max file size in bytes, 0 for a single file (else files are filename.0000, filename.0001...)
+        fsync_interval - seconds between fdatasync()s, 0 for never.  Read files with CdrSimpleLogFile
+        """
+        count = len(handles)
+        c_handles = (ctypes.c_int * count)(*handles)
+        ret = self.library.CdrOpenSimpleLog(filename, c_handles, count, rotate_size, fsync_interval)
+        if (ret < 0): raise Exception("Error while Opening Simple Log, errcode: %s" % ret)
+        return ret
+
+    def CdrCloseSimpleLog(self, log_id):
+        """
+        Stops logging, writes out buffered records and closes the file
+        """
+        ret = self.library.CdrCloseSimpleLog(log_id)
+        if (ret != 0): raise Exception("Error while Closing Simple Log, errcode: %s" % ret)
+        return ret
+
+    def CdrGetSimpleLogStats(self, log_id):
+        """
+        Returns (written, dropped) record counters of binary log
+        """
+        written = ctypes.c_uint64(0)
+        dropped = ctypes.c_uint64(0)
+        ret = self.library.CdrGetSimpleLogStats(log_id, ctypes.byref(written), ctypes.byref(dropped))
+        if (ret != 0): raise Exception("Error while Getting Simple Log Stats, errcode: %s" % ret)
+        return written.value, dropped.value
+
+    def CdrSaveSimpleSnapshot(self, path, handles=None):
+        """
+        Saves current values of Simple Channels (None - all registered, [] - none) into binary snapshot file,
+        returns number of channels saved
+        """
+        if handles is None:
+            c_handles, count = None, 0
+        else:
+            count = len(handles)
+            c_handles = (ctypes.c_int * count)(*handles)
+        ret = self.library.CdrSaveSimpleSnapshot(path, c_handles, count)
+        if (ret < 0): raise Exception("Error while Saving Simple Snapshot, errcode: %s" % ret)
+        return ret
+
+    def CdrRestoreSimpleSnapshot(self, path, diff=False, tolerance=0.0):
+        """
+        Writes snapshot values to registered writable Simple Channels with the same names,
+        returns (written, missing, failed) counts.
+        diff - write only channels whose live values differ from saved ones by more than tolerance
+        """
+        missing = ctypes.c_int(0)
+        failed = ctypes.c_int(0)
+        mode = self.SNAP_DIFF if diff else self.SNAP_ALL
+        ret = self.library.CdrRestoreSimpleSnapshot(path, mode, tolerance, ctypes.byref(missing), ctypes.byref(failed))
+        if (ret < 0): raise Exception("Error while Restoring Simple Snapshot, errcode: %s" % ret)
+        return ret, missing.value, failed.value
+
+#############################################
+class CdrUpdateStream(object):
+    """
+    Asynchronous iterator of update records (kind, handle, val, rflags, timestamp), made by CdrAsyncAdapter.Updates()
+    Records are buffered while nobody awaits; with maxlen only the newest maxlen are kept.
+    """
+    def __init__(self, adapter, keys, maxlen):
+        import collections
+        self.adapter = adapter
+        self.keys = keys
+        self._pending = collections.deque(maxlen=maxlen)
+        self._waiter = None
+        self._closed = False
+
+    def _Push(self, rec):
+        if self._waiter is not None and not self._waiter.done():
+            self._waiter.set_result(rec)
+        else:
+            self._pending.append(rec)
+        self._waiter = None
+
+    def __aiter__(self):
+        return self
+
+    def __anext__(self):
+        ### Plain future instead of a coroutine: keeps the module importable by python2
+        future = self.adapter.loop.create_future()
+        if self._pending:
+            future.set_result(self._pending.popleft())
+        elif self._closed:
+            future.set_exception(StopAsyncIteration())
+        else:
+            self._waiter = future
+        return future
+
+    def Close(self):
+        """
+        Ends iteration (after buffered records)
+        """
+        if self._closed: return
+        self._closed = True
+        self.adapter._streams.remove(self)
+        if self._waiter is not None and not self._waiter.done():
+            self._waiter.set_exception(StopAsyncIteration())
+        self._waiter = None
+
+class CdrAsyncAdapter(object):
+    """
+    Runs simple-access channels from an asyncio event loop, no GUI toolkit needed.
+    Starts threaded mode (if not yet) and watches its queue fd with loop.add_reader().
+
+    EXAMPLE:
+    adapter = CdrAsyncAdapter(wrapper)
+    async for kind, handle, val, rflags, timestamp in adapter.Updates(handles):
+        ...
+    rec = await adapter.Set(handle, 12.1, timeout=5)
+    """
+    def __init__(self, wrapper, loop=None, queue_size=0):
+        import asyncio
+        self.wrapper = wrapper
+        self.loop = loop if loop is not None else asyncio.get_event_loop()
+        self._streams = []
+        self._waiters = {} # (kind, handle) -> list of futures
+        if wrapper.CdrSimpleQueueFd() < 0: wrapper.CdrSimpleStartThread(queue_size)
+        self.fd = wrapper.CdrSimpleQueueFd()
+        self.loop.add_reader(self.fd, self._OnReadable)
+
+    def _OnReadable(self):
+        for rec in self.wrapper.CdrSimpleDrainQueue():
+            key = (rec[0], rec[1])
+            for future in self._waiters.pop(key, ()):
+                if not future.done(): future.set_result(rec)
+            for stream in self._streams:
+                if stream.keys is None or key in stream.keys: stream._Push(rec)
+
+    def Updates(self, handles=None, kind=CdrWrapper.UPD_CHAN, maxlen=None):
+        """
+        Returns asynchronous iterator (for "async for") of update records
+        handles - list of handles of the given kind, None for all updates of all kinds
+        maxlen - max records buffered while the consumer lags, None for unlimited
+        """
+        keys = None if handles is None else set((kind, h) for h in handles)
+        stream = CdrUpdateStream(self, keys, maxlen)
+        self._streams.append(stream)
+        return stream
+
+    def NextUpdate(self, handle, kind=CdrWrapper.UPD_CHAN, timeout=None):
+        """
+        Returns awaitable yielding the next update record of the channel
+        """
+        import asyncio
+        future = self.loop.create_future()
+        self._waiters.setdefault((kind, handle), []).append(future)
+        if timeout is None: return future
+        return asyncio.wait_for(future, timeout)
+
+    def SetAsync(self, handle, val, timeout=None):
+        """
+        Queues async write; returns awaitable yielding its (kind, handle, val, err, timestamp) completion record.
+        Writes coalesced into a later one complete with that one's record.
+        """
+        awaitable = self.NextUpdate(handle, CdrWrapper.UPD_WRITE, timeout)
+        self.wrapper.CdrSetSimpleChanValAsync(handle, val)
+        return awaitable
+
+    def Set(self, handle, val, timeout=None):
+        """
+        Writes Simple Chan value now (other pending async writes are flushed along);
+        returns awaitable yielding the (kind, handle, val, err, timestamp) completion record of this write
+        """
+        awaitable = self.NextUpdate(handle, CdrWrapper.UPD_WRITE, timeout)
+        self.wrapper.CdrSetSimpleChanValAsync(handle, val)
+        self.wrapper.CdrFlushSimpleWrites()
+        return awaitable
+
+    def Close(self, stop_thread=False):
+        """
+        Stops watching the queue fd, ends all iterators and cancels pending Set()s
+        """
+        self.loop.remove_reader(self.fd)
+        for stream in list(self._streams): stream.Close()
+        for futures in self._waiters.values():
+            for future in futures: future.cancel()
+        self._waiters = {}
+        if stop_thread: self.wrapper.CdrSimpleStopThread()
+
+class CdrSimpleLogFile(object):
+    """
+    Memory-mapped reader of a CdrOpenSimpleLog() file (one file of a rotated set), needs no library.
+    channels - {handle: name}; Records() - all records; Channel(handle) - one channel's data.
+    Arrays are NumPy views of the mapping if NumPy is available (drop them before Close()), else lists.
+
+    EXAMPLE:
+    log = CdrSimpleLogFile("beam.log")
+    times, vals = log.Channel(log.Handle(b"linac.current"))
+    """
+    MAGIC = b"CdrSLog1"
+    VERSION = 1
+    _HEADER = "=8sIIIId"
+    _CHAN_ENTRY = "=iI"
+    _RECORD = "=ddii"
+    _NUMPY_DTYPE = [("timestamp", "=f8"), ("value", "=f8"), ("handle", "=i4"), ("rflags", "=i4")]
+
+    def __init__(self, path):
+        import mmap, struct
+        with open(path, "rb") as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+        magic, version, record_size, num_chans, self.data_offset, self.start_time = \
+            struct.unpack_from(self._HEADER, self._map, 0)
+        if magic != self.MAGIC or version != self.VERSION or record_size != struct.calcsize(self._RECORD):
+            self._map.close()
+            raise Exception("Not a simple log file (or unsupported version): %s" % path)
+        self.channels = {}
+        offset = struct.calcsize(self._HEADER)
+        entry_size = struct.calcsize(self._CHAN_ENTRY)
+        for i in range(num_chans):
+            handle, name_len = struct.unpack_from(self._CHAN_ENTRY, self._map, offset)
+            start = offset + entry_size
+            self.channels[handle] = self._map[start:start + name_len]
+            offset += (entry_size + name_len + 1 + 7) & ~7
+        ### A partially written tail record (of a live log) is ignored
+        self.num_records = (len(self._map) - self.data_offset) // record_size
+
+    def Handle(self, name):
+        """
+        Returns handle of the channel by name (as it was at logging time)
+        """
+        for handle, chan_name in self.channels.items():
+            if chan_name == name: return handle
+        raise KeyError(name)
+
+    def Records(self):
+        """
+        Returns all records: NumPy structured array (fields timestamp, value, handle, rflags)
+        or list of (timestamp, value, handle, rflags) tuples
+        """
+        try:
+            import numpy
+        except ImportError:
+            import struct
+            record_size = struct.calcsize(self._RECORD)
+            return [struct.unpack_from(self._RECORD, self._map, self.data_offset + i * record_size)
+                    for i in range(self.num_records)]
+        return numpy.frombuffer(self._map, dtype=self._NUMPY_DTYPE, count=self.num_records, offset=self.data_offset)
+
+    def Channel(self, handle):
+        """
+        Returns (timestamps, values) of one channel
+        """
+        records = self.Records()
+        if isinstance(records, list):
+            return [r[0] for r in records if r[2] == handle], [r[1] for r in records if r[2] == handle]
+        selected = records[records["handle"] == handle]
+        return selected["timestamp"], selected["value"]
+
+    def Close(self):
+        self._map.close()
+
 #############################################
 ############### USE EXAMPLE #################
 #############################################
@@ -3,11 +3,29 @@
 #include <stdarg.h>
 #include <unistd.h>
 #include <limits.h>
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/time.h>
+#include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#if defined(__x86_64__)  ||  defined(__i386__)
+#include <immintrin.h>
+#endif
+#ifdef __ARM_NEON
+#include <arm_neon.h>
+#endif
 
 #include <dlfcn.h>
 
 #include "misc_macros.h"
 #include "misclib.h"
+#include "cxscheduler.h"
 
 #include "cx_sysdeps.h"
 
@@ -36,9 +54,542 @@ static void reporterror(const char *format, ...)
 }
 
 
+//// Name indexes //////////////////////////////////////////////////
+
+/* A case-insensitive name->id hash.  Ids are slot numbers (small and
+   dense), so chains are linked through a per-id array instead of
+   separately allocated nodes; names are fetched from the slots
+   themselves via getname(). */
+
+typedef const char *(*nameidx_getname_t)(void *privptr, int id);
+
+typedef struct
+{
+    int               *heads;      // [heads_size], -1 terminates a chain
+    int                heads_size; // 0 or a power of 2
+    int               *links;      // [links_size], next id in chain
+    int                links_size;
+    int                count;
+    nameidx_getname_t  getname;
+    void              *privptr;
+} nameidx_t;
+
+enum {NAMEIDX_MIN_HEADS = 64};
+
+static unsigned int NameHash(const char *name)
+{
+  unsigned int  h = 2166136261u; // FNV-1a
+
+    for (;  *name != '\0';  name++)
+        h = (h ^ (unsigned char)tolower((unsigned char)*name)) * 16777619u;
+
+    return h;
+}
+
+static void NameIdxLink(nameidx_t *idx, int id)
+{
+  int  b = NameHash(idx->getname(idx->privptr, id)) & (idx->heads_size - 1);
+
+    idx->links[id] = idx->heads[b];
+    idx->heads[b]  = id;
+}
+
+static int  NameIdxRehash(nameidx_t *idx, int new_size)
+{
+  int *new_heads;
+  int *old_heads  = idx->heads;
+  int  old_size   = idx->heads_size;
+  int  b;
+  int  id;
+  int  nxt;
+
+    if ((new_heads = malloc(new_size * sizeof(*new_heads))) == NULL) return -1;
+    for (b = 0;  b < new_size;  b++) new_heads[b] = -1;
+
+    idx->heads      = new_heads;
+    idx->heads_size = new_size;
+    for (b = 0;  b < old_size;  b++)
+        for (id = old_heads[b];  id >= 0;  id = nxt)
+        {
+            nxt = idx->links[id];
+            NameIdxLink(idx, id);
+        }
+    safe_free(old_heads);
+
+    return 0;
+}
+
+static int  NameIdxAdd (nameidx_t *idx, int id)
+{
+  int *new_links;
+  int  new_size;
+
+    if (id >= idx->links_size)
+    {
+        new_size = idx->links_size * 2;
+        if (new_size <= id) new_size = id + 1;
+        new_links = realloc(idx->links, new_size * sizeof(*new_links));
+        if (new_links == NULL) return -1;
+        idx->links      = new_links;
+        idx->links_size = new_size;
+    }
+    if (idx->count >= idx->heads_size  &&
+        NameIdxRehash(idx,
+                      idx->heads_size == 0? NAMEIDX_MIN_HEADS
+                                          : idx->heads_size * 2) != 0)
+        return -1;
+
+    NameIdxLink(idx, id);
+    idx->count++;
+
+    return 0;
+}
+
+static void NameIdxDel (nameidx_t *idx, int id)
+{
+  int *p;
+
+    if (idx->heads_size == 0) return;
+
+    for (p = idx->heads + (NameHash(idx->getname(idx->privptr, id)) & (idx->heads_size - 1));
+         *p >= 0;
+         p = idx->links + *p)
+        if (*p == id)
+        {
+            *p = idx->links[id];
+            idx->count--;
+            return;
+        }
+}
+
+static int  NameIdxFind(nameidx_t *idx, const char *name)
+{
+  int  id;
+
+    if (idx->heads_size == 0) return -1;
+
+    for (id = idx->heads[NameHash(name) & (idx->heads_size - 1)];
+         id >= 0;
+         id = idx->links[id])
+        if (strcasecmp(name, idx->getname(idx->privptr, id)) == 0)
+            return id;
+
+    return -1;
+}
+
+static void NameIdxFree(nameidx_t *idx)
+{
+    safe_free(idx->heads); idx->heads = NULL; idx->heads_size = 0;
+    safe_free(idx->links); idx->links = NULL; idx->links_size = 0;
+    idx->count = 0;
+}
+
+//// Threading ///////////////////////////////////////////////////////
+
+/* All public entry points run under simple_lock (a recursive one, since
+   entry points may be called from callbacks).  In threaded mode the event
+   thread holds it all the time except while sleeping in select(), so slot
+   arrays and cda are never touched concurrently. */
+
+static pthread_mutex_t simple_lock;
+static pthread_once_t  simple_lock_once = PTHREAD_ONCE_INIT;
+
+static void SimpleLockInit   (void)
+{
+  pthread_mutexattr_t  attr;
+
+    pthread_mutexattr_init   (&attr);
+    pthread_mutexattr_settype(&attr, PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init       (&simple_lock, &attr);
+    pthread_mutexattr_destroy(&attr);
+}
+
+static int  SimpleLock       (void)
+{
+    pthread_once(&simple_lock_once, SimpleLockInit);
+    pthread_mutex_lock(&simple_lock);
+    return 0;
+}
+
+static void SimpleUnlock     (void)
+{
+    pthread_mutex_unlock(&simple_lock);
+}
+
+static void SimpleUnlockGuard(int *guard __attribute__((unused)))
+{
+    SimpleUnlock();
+}
+
+#define SIMPLE_LOCKED() \
+    int simple_lock_guard __attribute__((cleanup(SimpleUnlockGuard), unused)) = SimpleLock()
+
+/* Update queue: a bounded lock-free MPMC queue (sequence-numbered cells),
+   filled by the event thread and drained by any number of consumers.
+   queue_fd (an eventfd) is readable while the queue may be non-empty.
+   Lock-free drainers are counted in updq_users, and UpdQueueFini() waits
+   for them after raising updq_closing, so that the queue isn't freed
+   under them (a rwlock would let steady drainers starve it). */
+
+enum {UPDQ_DEF_SIZE = 65536};
+
+typedef struct
+{
+    unsigned int       seq;
+    CdrSimpleUpdate_t  upd;
+} updcell_t;
+
+static int           simple_threaded = 0;
+static pthread_t     simple_thread;
+static int           simple_wake_fd  = -1;  // Makes the loop notice a stop request
+static sl_fdh_t      simple_wake_fdh = -1;
+
+static updcell_t    *updq_cells   = NULL;
+static unsigned int  updq_mask    = 0;
+static unsigned int  updq_head    = 0;   // Consumers' position
+static unsigned int  updq_tail    = 0;   // Producer's position
+static unsigned int  updq_pushed  = 0;
+static unsigned int  updq_dropped = 0;
+static int           updq_fd      = -1;
+static int           updq_users   = 0;
+static int           updq_closing = 0;
+
+static int  UpdQueueInit(int size)
+{
+  unsigned int  cap;
+  unsigned int  n;
+  int           fd;
+
+    for (cap = 2;  cap < (unsigned int)size;  cap *= 2);
+
+    if ((updq_cells = malloc(cap * sizeof(*updq_cells))) == NULL) return -1;
+    for (n = 0;  n < cap;  n++) updq_cells[n].seq = n;
+    updq_mask    = cap - 1;
+    updq_head    = updq_tail = 0;
+    updq_pushed  = updq_dropped = 0;
+
+    if ((fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0)
+    {
+        safe_free(updq_cells); updq_cells = NULL;
+        return -1;
+    }
+    /* Publish last: drainers check fd only */
+    __atomic_store_n(&updq_closing, 0,  __ATOMIC_SEQ_CST);
+    __atomic_store_n(&updq_fd,      fd, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+static void UpdQueueFini(void)
+{
+    __atomic_store_n(&updq_closing, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&updq_users, __ATOMIC_SEQ_CST) > 0) sched_yield();
+
+    if (updq_fd >= 0) close(updq_fd);
+    __atomic_store_n(&updq_fd, -1, __ATOMIC_RELEASE);
+    safe_free(updq_cells); updq_cells = NULL;
+}
+
+/* Returns 0 if the queue may be used till UpdQueueLeave() */
+static int  UpdQueueEnter(void)
+{
+    __atomic_add_fetch(&updq_users, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&updq_closing, __ATOMIC_SEQ_CST)  ||
+        __atomic_load_n(&updq_fd,      __ATOMIC_ACQUIRE) < 0)
+    {
+        __atomic_sub_fetch(&updq_users, 1, __ATOMIC_RELEASE);
+        return -1;
+    }
+
+    return 0;
+}
+
+static void UpdQueueLeave(void)
+{
+    __atomic_sub_fetch(&updq_users, 1, __ATOMIC_RELEASE);
+}
+
+static int  UpdQueuePush(const CdrSimpleUpdate_t *u)
+{
+  unsigned int  pos = __atomic_load_n(&updq_tail, __ATOMIC_RELAXED);
+  updcell_t    *c;
+  int           dif;
+
+    for (;;)
+    {
+        c   = updq_cells + (pos & updq_mask);
+        dif = (int)(__atomic_load_n(&(c->seq), __ATOMIC_ACQUIRE) - pos);
+        if      (dif == 0)
+        {
+            if (__atomic_compare_exchange_n(&updq_tail, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (dif <  0)
+        {
+            __atomic_add_fetch(&updq_dropped, 1, __ATOMIC_RELAXED);
+            return -1;
+        }
+        else
+            pos = __atomic_load_n(&updq_tail, __ATOMIC_RELAXED);
+    }
+
+    c->upd = *u;
+    __atomic_store_n(&(c->seq), pos + 1, __ATOMIC_RELEASE);
+    __atomic_add_fetch(&updq_pushed, 1, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+static int  UpdQueuePop (CdrSimpleUpdate_t *u)
+{
+  unsigned int  pos = __atomic_load_n(&updq_head, __ATOMIC_RELAXED);
+  updcell_t    *c;
+  int           dif;
+
+    for (;;)
+    {
+        c   = updq_cells + (pos & updq_mask);
+        dif = (int)(__atomic_load_n(&(c->seq), __ATOMIC_ACQUIRE) - (pos + 1));
+        if      (dif == 0)
+        {
+            if (__atomic_compare_exchange_n(&updq_head, &pos, pos + 1, 1,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        else if (dif <  0)
+            return -1;
+        else
+            pos = __atomic_load_n(&updq_head, __ATOMIC_RELAXED);
+    }
+
+    *u = c->upd;
+    __atomic_store_n(&(c->seq), pos + updq_mask + 1, __ATOMIC_RELEASE);
+
+    return 0;
+}
+
+/* A released channel/bigc may still be referenced by queued records,
+   so its id is "quarantined" until consumers have taken all of them
+   (i.e. the head passed the tail at release time) */
+static int  UpdQueuePassed(int quarantined, unsigned int released_at)
+{
+    return !quarantined  ||
+           (int)(__atomic_load_n(&updq_head, __ATOMIC_ACQUIRE) - released_at) >= 0;
+}
+
+static void UpdQueueSignal(void)
+{
+  uint64_t  one = 1;
+
+    if (write(updq_fd, &one, sizeof(one)) < 0) {/* Counter overflow is harmless: fd is readable anyway */}
+}
+
+static double SimpleTimestamp(void)
+{
+  struct timeval  now;
+
+    gettimeofday(&now, NULL);
+
+    return now.tv_sec + now.tv_usec / 1000000.0;
+}
+
+static void QueueUpdate(int kind, int handle, double val, int rflags, double timestamp)
+{
+  CdrSimpleUpdate_t  u;
+
+    u.kind      = kind;
+    u.handle    = handle;
+    u.val       = val;
+    u.rflags    = rflags;
+    u.timestamp = timestamp;
+    UpdQueuePush(&u);
+}
+
+static void SelectBeforeHook(void)
+{
+    SimpleUnlock();
+}
+
+static void SelectAfterHook (void)
+{
+    SimpleLock();
+}
+
+static void SimpleWakeProc(int uniq __attribute__((unused)), void *privptr1 __attribute__((unused)),
+                           sl_fdh_t fdh __attribute__((unused)), int fd,
+                           int mask __attribute__((unused)), void *privptr2 __attribute__((unused)))
+{
+  uint64_t  counter;
+
+    if (read(fd, &counter, sizeof(counter)) < 0) {/* EAGAIN: spurious */}
+    sl_break();
+}
+
+static void *SimpleThreadProc(void *arg __attribute__((unused)))
+{
+    SimpleLock();
+    sl_set_select_behaviour(SelectBeforeHook, SelectAfterHook, 0);
+    sl_main_loop();
+    sl_set_select_behaviour(NULL, NULL, 0);
+    SimpleUnlock();
+
+    return NULL;
+}
+
+//// Instrumentation /////////////////////////////////////////////////
+
+/* Opt-in (CdrSimpleEnablePerf()); per-slot perf records are allocated
+   on first use, so that disabled instrumentation costs one flag check.
+   Histograms are log-linear (HDR-like): CDR_SIMPLE_HIST_SUB sub-buckets
+   per power of 2, i.e. <=25% relative error, in ~1KB. */
+
+static int       perf_on    = 0;
+static uint64_t  perf_since = 0;
+
+static uint64_t PerfNow(void)
+{
+  struct timespec  now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return (uint64_t)now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+static int HistBucketOf(uint64_t v)
+{
+  int  e;
+  int  b;
+
+    if (v < 2 * CDR_SIMPLE_HIST_SUB) return v;
+
+    e = 63 - __builtin_clzll(v);
+    b = (e - CDR_SIMPLE_HIST_SUB_BITS + 1) * CDR_SIMPLE_HIST_SUB +
+        ((v >> (e - CDR_SIMPLE_HIST_SUB_BITS)) & (CDR_SIMPLE_HIST_SUB - 1));
+
+    return b < CDR_SIMPLE_HIST_BUCKETS? b : CDR_SIMPLE_HIST_BUCKETS - 1;
+}
+
+static void HistRecord(CdrSimpleHist_t *h, uint64_t v)
+{
+    if (h->count == 0  ||  v < h->min) h->min = v;
+    if (h->count == 0  ||  v > h->max) h->max = v;
+    h->count++;
+    h->sum += v;
+    h->buckets[HistBucketOf(v)]++;
+}
+
+/* Returns the perf record, allocating it if needed; NULL if disabled */
+static void *PerfOf(void **perf_p, size_t size)
+{
+    if (!perf_on) return NULL;
+    if (*perf_p == NULL) *perf_p = calloc(1, size);
+    return *perf_p;
+}
+
 //// Slotarrays management ///////////////////////////////////////////
 
-enum {NUMLOCALREGS = 1000};
+/* Slot arrays of subsystems and channels are chunked: chunk #c holds
+   SLOTCHUNK_BASE<<c slots, so growth is geometric, nothing is ever
+   copied and slot pointers stay valid across registrations (e.g. in
+   callbacks).  API is the same as GENERIC_SLOTARRAY_DEFINE_GROWING's,
+   with __arrname##_chunks[] instead of __arrname##_list, plus
+   __reusable(p) -- whether a free slot may be handed out again.
+   Access*Slot() returns NULL for ids outside [0,list_allocd), so the
+   usual "id < 0  ||  id >= list_allocd  ||  p->in_use == 0" checks
+   after it never touch the pointer. */
+
+enum
+{
+    SLOTCHUNK_BASE_LOG = 4,
+    SLOTCHUNK_BASE     = 1 << SLOTCHUNK_BASE_LOG,
+    /* Covers chunks of all non-negative int ids; the last 2 are
+       never allocated, to keep list_allocd in int */
+    SLOTCHUNKS_MAX     = 32 - SLOTCHUNK_BASE_LOG + 1,
+};
+
+static inline int SlotChunkOf(int id)
+{
+    return 31 - __builtin_clz((unsigned int)id / SLOTCHUNK_BASE + 1);
+}
+
+static inline unsigned int SlotChunkStart(int chunk)
+{
+    return SLOTCHUNK_BASE * ((1U << chunk) - 1);
+}
+
+#define STABLE_SLOTARRAY_DEFINE_GROWING(__scope, __prefix, __type,             \
+                                        __arrname, __inuse, __empty, __used,   \
+                                        __min_id, __reusable)                  \
+__scope __type *Access##__prefix##Slot(int id)                                 \
+{                                                                              \
+  int  chunk;                                                                  \
+                                                                               \
+    if (id < 0  ||  id >= __arrname##_list_allocd) return NULL;                \
+    chunk = SlotChunkOf(id);                                                   \
+    return __arrname##_chunks[chunk] +                                         \
+           ((unsigned int)id - SlotChunkStart(chunk));                         \
+}                                                                              \
+                                                                               \
+__scope int Get##__prefix##Slot(void)                                          \
+{                                                                              \
+  int      id;                                                                 \
+  int      chunk;                                                              \
+  __type  *p;                                                                  \
+                                                                               \
+    for (id = __min_id;  id < __arrname##_list_allocd;  id++)                  \
+        if (Access##__prefix##Slot(id)->__inuse == __empty  &&                 \
+            __reusable(Access##__prefix##Slot(id)))                            \
+            goto FOUND;                                                        \
+                                                                               \
+    chunk = __arrname##_list_allocd == 0? 0                                    \
+                                        : SlotChunkOf(__arrname##_list_allocd);\
+    if (chunk >= SLOTCHUNKS_MAX - 2) return -1;                                \
+    if ((p = calloc(SLOTCHUNK_BASE << chunk, sizeof(*p))) == NULL) return -1;  \
+    __arrname##_chunks[chunk] = p;                                             \
+    id = __arrname##_list_allocd > __min_id? __arrname##_list_allocd           \
+                                           : __min_id;                         \
+    __arrname##_list_allocd = (int)SlotChunkStart(chunk + 1);                  \
+                                                                               \
+ FOUND:                                                                        \
+    p = Access##__prefix##Slot(id);                                            \
+    bzero(p, sizeof(*p));                                                      \
+    p->__inuse = __used;                                                       \
+                                                                               \
+    return id;                                                                 \
+}                                                                              \
+                                                                               \
+__scope int Foreach##__prefix##Slot(int (*checker)(__type *, void *),         \
+                                    void *privptr)                             \
+{                                                                              \
+  int      id;                                                                 \
+  __type  *p;                                                                  \
+                                                                               \
+    for (id = __min_id;  id < __arrname##_list_allocd;  id++)                  \
+    {                                                                          \
+        p = Access##__prefix##Slot(id);                                        \
+        if (p->__inuse != __empty  &&  checker(p, privptr)) return id;         \
+    }                                                                          \
+                                                                               \
+    return -1;                                                                 \
+}
+
+#define SLOT_ALWAYS_REUSABLE(p) 1
+#define SLOT_OUT_OF_QUEUE(p)    UpdQueuePassed((p)->quarantined, (p)->released_at)
+
+enum {NUMLOCALREGS = 1000};   // # of local registers if formulas compute register numbers
+
+typedef struct
+{
+    char  *name;
+    Knob   k;
+} knobref_t;
+
+typedef struct
+{
+    Knob   k;
+    int    n;
+} knobrun_t;
 
 typedef struct
 {
@@ -48,42 +599,128 @@ typedef struct
   subsysdescr_t  *info;
   cda_serverid_t  mainsid;
   groupelem_t    *grouplist;
-  double          localregs      [NUMLOCALREGS];
-  char            localregsinited[NUMLOCALREGS];
+  knobref_t      *knobs;        // Flat name->Knob list, built once from grouplist
+  int             knobs_count;
+  int             knobs_allocd;
+  nameidx_t       knob_idx;
+  double         *localregs;    // [numlocalregs]
+  char           *localregsinited;
+  int             numlocalregs;
+  int             localregs_set; // numlocalregs was set explicitly
 
   int             frs_cid;
   int             frs_bid;
-} simplesubsys_t;
+  CdrSimpleSubsysPerf_t *perf;
+  int             frs_wcid;     // Channels with pending async writes...
+  int             lst_wcid;     // ...in request order
 
-enum
-{
-    SUBSYS_MAX       = 0,
-    SUBSYS_ALLOC_INC = 2,     // Must be >1 (to provide growth from 0 to 2)
-};
+  int             dispatch_mode;
+
+  int             process_mode;
+  knobrun_t      *lazy_runs;    // [lazy_runs_allocd], what PROCESS_REGISTERED evaluates
+  int             lazy_runs_count;
+  int             lazy_runs_allocd;
+  int             lazy_dirty;   // Set of channels/dependencies changed
+  knobref_t      *deps;         // [deps_allocd], explicit dependencies
+  int             deps_count;
+  int             deps_allocd;
+
+  int             refcount;     // # of registered scalar+big channels
+  int             configured;   // Has settings, so is only unloaded when unused
+  int             nchans;
+  CdrSimpleCycleCB_t  cycle_cb;
+  void               *cycle_privptr;
+  int                *cycle_handles; // [cycle_allocd]
+  double             *cycle_vals;
+  int                *cycle_rflags;
+  int                 cycle_allocd;
+} simplesubsys_t;
 
-static simplesubsys_t *subsys_list        = NULL;
+static simplesubsys_t *subsys_chunks[SLOTCHUNKS_MAX];
 static int             subsys_list_allocd = 0;
 
 // GetSubsysSlot()
-GENERIC_SLOTARRAY_DEFINE_GROWING(static, Subsys, simplesubsys_t,
-                                 subsys, in_use, 0, 1,
-                                 1, SUBSYS_ALLOC_INC, SUBSYS_MAX,
-                                 , , void)
+STABLE_SLOTARRAY_DEFINE_GROWING(static, Subsys, simplesubsys_t,
+                                subsys, in_use, 0, 1,
+                                1, SLOT_ALWAYS_REUSABLE)
 
-static void RlsSubsysSlot(int yid)
+static const char *subsys_idx_getname(void *privptr __attribute__((unused)), int yid)
+{
+    return AccessSubsysSlot(yid)->subsysname;
+}
+
+static nameidx_t subsys_idx = {NULL, 0, NULL, 0, 0, subsys_idx_getname, NULL};
+
+/* Releases what the loaded subsystem holds (server, grouplist, knobs),
+   but keeps the slot with settings made via API, for a later reload */
+static void UnloadSubsys(int yid)
 {
   simplesubsys_t *syp = AccessSubsysSlot(yid);
   int             err = errno;        // To preserve errno
+  int             n;
 
-    if (yid < 0  ||  yid >= subsys_list_allocd  ||  syp->in_use == 0) return;
+    safe_free(syp->perf); syp->perf = NULL;
+
+    for (n = 0;  n < syp->knobs_count;  n++) safe_free(syp->knobs[n].name);
+    safe_free(syp->knobs); syp->knobs = NULL;
+    syp->knobs_count = syp->knobs_allocd = 0;
+    NameIdxFree(&(syp->knob_idx));
+
+    safe_free(syp->cycle_handles); syp->cycle_handles = NULL;
+    safe_free(syp->cycle_vals);    syp->cycle_vals    = NULL;
+    safe_free(syp->cycle_rflags);  syp->cycle_rflags  = NULL;
+    syp->cycle_allocd = 0;
+
+    /* Size is a setting, while values belong to this load */
+    if (syp->numlocalregs > 0)
+    {
+        bzero(syp->localregs,       syp->numlocalregs * sizeof(*(syp->localregs)));
+        bzero(syp->localregsinited, syp->numlocalregs * sizeof(*(syp->localregsinited)));
+    }
+
+    safe_free(syp->lazy_runs); syp->lazy_runs = NULL;
+    syp->lazy_runs_count = syp->lazy_runs_allocd = 0;
+    syp->lazy_dirty      = 1;
+    for (n = 0;  n < syp->deps_count;  n++) syp->deps[n].k = NULL;
 
     if (syp->grouplist != NULL)               CdrDestroyGrouplist(syp->grouplist);
     if (syp->mainsid   != CDA_SERVERID_ERROR) cda_del_server(syp->mainsid);
     if (syp->handle    != NULL)               dlclose(syp->handle);
+    syp->grouplist = NULL;
+    syp->mainsid   = CDA_SERVERID_ERROR;
+    syp->handle    = NULL;
+    syp->info      = NULL;
+
+    errno = err;
+}
+
+static void RlsSubsysSlot(int yid)
+{
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  int             n;
+
+    if (yid < 0  ||  yid >= subsys_list_allocd  ||  syp->in_use == 0) return;
+
+    NameIdxDel(&subsys_idx, yid);
+
+    UnloadSubsys(yid);
+
+    safe_free(syp->localregs);       syp->localregs       = NULL;
+    safe_free(syp->localregsinited); syp->localregsinited = NULL;
+    syp->numlocalregs = 0;
+
+    for (n = 0;  n < syp->deps_count;  n++) safe_free(syp->deps[n].name);
+    safe_free(syp->deps);      syp->deps      = NULL;
+    syp->deps_count      = syp->deps_allocd      = 0;
 
     syp->in_use = 0;
+}
 
-    errno = err;
+/* A subsystem with settings is unloaded, otherwise forgotten at all */
+static void DropSubsys(int yid)
+{
+    if (AccessSubsysSlot(yid)->configured) UnloadSubsys (yid);
+    else                                   RlsSubsysSlot(yid);
 }
 
 //--------------------------------------------------------------------
@@ -97,33 +734,83 @@ typedef struct
     CdrSimpleChanNewValCB_t  cb;
     void                    *privptr;
     int                      nxt_cid;
+    int                      dying;           // Unregistered during dispatch
+    int                      quarantined;     // Released, see UpdQueuePassed()
+    unsigned int             released_at;
+    // Async writes
+    int                      write_pending;
+    double                   write_v;         // Last requested value
+    int                      nxt_wcid;
+    // History ring
+    double                  *hist_vals;       // [hist_size]
+    double                  *hist_times;
+    int                      hist_size;
+    int                      hist_first;      // Oldest point
+    int                      hist_used;
+    // Binary logs the channel is recorded to
+    int                     *log_ids;         // [log_ids_allocd]
+    int                      log_ids_count;
+    int                      log_ids_allocd;
+    //
+    CdrSimpleChanPerf_t     *perf;
+    //
+    int                      dispatch_mode;
+    int                      have_last;
+    double                   last_v;
+    rflags_t                 last_rflags;
+    // Filtering (see ChanFilterPass())
+    double                   min_interval;    // 1/max_rate; 0 -- unlimited
+    double                   deadband_abs;
+    double                   deadband_rel;
+    int                      filter_pending;  // A rate-limited value awaits delivery
+    int                      have_sent;
+    double                   sent_v;
+    rflags_t                 sent_rflags;
+    double                   sent_time;
+    unsigned int             n_delivered;
+    unsigned int             n_suppressed;
 } simplechan_t;
 
-enum
-{
-    SMPLCH_MAX       = 0,
-    SMPLCH_ALLOC_INC = 2,     // Must be >1 (to provide growth from 0 to 2)
-};
-
-static simplechan_t *smplch_list        = NULL;
+static simplechan_t *smplch_chunks[SLOTCHUNKS_MAX];
 static int           smplch_list_allocd = 0;
 
 // GetSmplchSlot()
-GENERIC_SLOTARRAY_DEFINE_GROWING(static, Smplch, simplechan_t,
-                                 smplch, in_use, 0, 1,
-                                 1, SMPLCH_ALLOC_INC, SMPLCH_MAX,
-                                 , , void)
+STABLE_SLOTARRAY_DEFINE_GROWING(static, Smplch, simplechan_t,
+                                smplch, in_use, 0, 1,
+                                1, SLOT_OUT_OF_QUEUE)
+
+static const char *smplch_idx_getname(void *privptr __attribute__((unused)), int cid)
+{
+    return AccessSmplchSlot(cid)->name;
+}
+
+static nameidx_t smplch_idx = {NULL, 0, NULL, 0, 0, smplch_idx_getname, NULL};
 
 static void RlsSmplchSlot(int cid)
 {
   simplechan_t *scp = AccessSmplchSlot(cid);
 
+    if (scp->name != NULL) NameIdxDel(&smplch_idx, cid);
     safe_free(scp->name);
+    /* Was a fully set-up channel, so subsystem's lazy set shrinks */
+    if (scp->k    != NULL) AccessSubsysSlot(scp->yid)->lazy_dirty = 1;
+    scp->k = NULL;
+    safe_free(scp->perf);
+    safe_free(scp->hist_vals);
+    safe_free(scp->hist_times);
+    safe_free(scp->log_ids);
     scp->in_use = 0;
 }
 
 //--------------------------------------------------------------------
 
+typedef struct
+{
+    size_t                   size;
+    tag_t                    tag;
+    rflags_t                 rflags;
+} bigcframe_t;
+
 typedef struct
 {
     int                      in_use;
@@ -133,516 +820,4656 @@ typedef struct
     CdrSimpleChanNewBigCB_t  cb;
     void                    *privptr;
     int                      nxt_bid;
+    int                      dying;           // Unregistered during dispatch
+    int                      quarantined;     // Released, see UpdQueuePassed()
+    unsigned int             released_at;
+    CdrSimpleBigcPerf_t     *perf;
     //
+    int                      srv_id;      // Bigc-server connection
+    int                      nxt_srv_bid; // Next bigc of the same connection
     cda_serverid_t           bigc_sid;
     cda_bigchandle_t         bigc_handle;
-    uint8                   *databuf;
+    size_t                   max_datasize;
+    uint8                   *databuf;     // [max_datasize], allocated on first use
+    size_t                   datasize;
+    int                      generation;  // Incremented on every event
+    int                      databuf_gen; // Generation copied into databuf
+    int                      view_holds;  // # of acquired, not yet released views
+    //
+    uint8                   *ring_buf;    // [ring_size * max_datasize]
+    bigcframe_t             *ring_frames; // [ring_size]
+    int                      ring_size;
+    int                      ring_policy;
+    int                      ring_first;
+    int                      ring_used;
+    unsigned int             ring_pushed;
+    unsigned int             ring_dropped;
+    // Decoding into physical units: raw/r-d
+    int                      decode_units;
+    double                   decode_r;
+    double                   decode_d;
+    // Reductions done on frame arrival (see ReduceFrame())
+    int                      reduce_flags;
+    uint8                   *reduce_buf;  // [max_datasize], while a view is held
+    CdrSimpleBigcFrameStats_t frame_stats;
+    double                  *decim_mins;  // [decim_points]
+    double                  *decim_maxs;
+    int                      decim_points;
+    int                      decim_count; // Of the last frame
+    int                      decim_gen;
 } splbigchan_t;
 
-enum
-{
-    SBIGCH_MAX       = 0,
-    SBIGCH_ALLOC_INC = 2,     // Must be >1 (to provide growth from 0 to 2)
-};
-
-static splbigchan_t *sbigch_list        = NULL;
+static splbigchan_t *sbigch_chunks[SLOTCHUNKS_MAX];
 static int           sbigch_list_allocd = 0;
 
 // GetSbigchSlot()
-GENERIC_SLOTARRAY_DEFINE_GROWING(static, Sbigch, splbigchan_t,
-                                 sbigch, in_use, 0, 1,
-                                 1, SBIGCH_ALLOC_INC, SBIGCH_MAX,
-                                 , , void)
+STABLE_SLOTARRAY_DEFINE_GROWING(static, Sbigch, splbigchan_t,
+                                sbigch, in_use, 0, 1,
+                                1, SLOT_OUT_OF_QUEUE)
+
+static const char *sbigch_idx_getname(void *privptr __attribute__((unused)), int bid)
+{
+    return AccessSbigchSlot(bid)->name;
+}
+
+static nameidx_t sbigch_idx = {NULL, 0, NULL, 0, 0, sbigch_idx_getname, NULL};
 
 static void RlsSbigchSlot(int bid)
 {
   splbigchan_t *sbp = AccessSbigchSlot(bid);
 
+    if (sbp->name != NULL) NameIdxDel(&sbigch_idx, bid);
     safe_free(sbp->name);
     safe_free(sbp->databuf);
+    safe_free(sbp->ring_buf);
+    safe_free(sbp->ring_frames);
+    safe_free(sbp->reduce_buf);
+    safe_free(sbp->decim_mins);
+    safe_free(sbp->decim_maxs);
+    safe_free(sbp->perf);
     sbp->in_use = 0;
 }
 
-//// Subsystem operation /////////////////////////////////////////////
+//--------------------------------------------------------------------
 
-static void EventProc(cda_serverid_t sid __attribute__((unused)), int reason, void *privptr)
-{
-  int                 yid  = ptr2lint(privptr);
-  simplesubsys_t     *syp = AccessSubsysSlot(yid);
-  cda_localreginfo_t  localreginfo;
+/* Bigc-server connections.  Each bigc currently gets its own one: a
+   shared connection would need to know which bigc an event is about,
+   and cda's event 'reason' isn't confirmed to carry the bigc handle */
 
+typedef struct
+{
+    int             in_use;
+    cda_serverid_t  sid;
+    int             refcount;
+    int             frs_bid;
+} bigcsrv_t;
+
+enum
+{
+    BIGCSRV_MAX       = 0,
+    BIGCSRV_ALLOC_INC = 2,     // Must be >1 (to provide growth from 0 to 2)
+};
+
+static bigcsrv_t *bigcsrv_list        = NULL;
+static int        bigcsrv_list_allocd = 0;
+
+// GetBigcsrvSlot()
+GENERIC_SLOTARRAY_DEFINE_GROWING(static, Bigcsrv, bigcsrv_t,
+                                 bigcsrv, in_use, 0, 1,
+                                 1, BIGCSRV_ALLOC_INC, BIGCSRV_MAX,
+                                 , , void)
+
+static void RlsBigcsrvSlot(int sv_id)
+{
+  bigcsrv_t *svp = AccessBigcsrvSlot(sv_id);
+  int        err = errno;        // To preserve errno
+
+    if (sv_id < 0  ||  sv_id >= bigcsrv_list_allocd  ||  svp->in_use == 0) return;
+
+    if (svp->sid != CDA_SERVERID_ERROR) cda_del_server(svp->sid);
+    svp->in_use = 0;
+
+    errno = err;
+}
+
+//--------------------------------------------------------------------
+
+/* Binary logs.  Slots are stable, since writer threads hold pointers */
+
+enum {SIMPLELOG_BUF_RECS = 8192};  // Records per each of 2 buffers
+
+typedef struct
+{
+    CdrSimpleLogRecord_t    *recs;            // [SIMPLELOG_BUF_RECS]
+    int                      count;
+} logbuf_t;
+
+typedef struct
+{
+    int                      in_use;
+    char                    *filename;
+    int                     *handles;         // [count]
+    int                      count;
+    uint8                   *header;          // Prebuilt file header, [header_size]
+    size_t                   header_size;
+    size_t                   rotate_size;
+    double                   fsync_interval;
+    //
+    int                      fd;
+    int                      file_seq;
+    size_t                   file_size;
+    int                      dirty;           // Written after last fsync
+    double                   last_fsync;
+    //
+    pthread_t                thread;
+    pthread_mutex_t          mutex;
+    pthread_cond_t           cond;
+    int                      sync_inited;
+    logbuf_t                 bufs[2];
+    int                      fill;            // Buffer being filled by the event loop
+    int                      stop;
+    int                      closing;         // Close is joining the writer
+    int                      write_errno;     // Last reported, to not flood stderr
+    uint64_t                 written;
+    uint64_t                 dropped;
+} simplelog_t;
+
+static simplelog_t *simplelog_chunks[SLOTCHUNKS_MAX];
+static int          simplelog_list_allocd = 0;
+
+// GetSimplelogSlot()
+STABLE_SLOTARRAY_DEFINE_GROWING(static, Simplelog, simplelog_t,
+                                simplelog, in_use, 0, 1,
+                                1, SLOT_ALWAYS_REUSABLE)
+
+/* Note: the writer thread must be already stopped */
+static void RlsSimplelogSlot(int log_id)
+{
+  simplelog_t *lp  = AccessSimplelogSlot(log_id);
+  int          err = errno;        // To preserve errno
+
+    if (log_id < 0  ||  log_id >= simplelog_list_allocd  ||  lp->in_use == 0) return;
+
+    if (lp->fd >= 0)
+    {
+        if (lp->fsync_interval > 0) fdatasync(lp->fd);
+        close(lp->fd);
+    }
+    if (lp->sync_inited)
+    {
+        pthread_mutex_destroy(&(lp->mutex));
+        pthread_cond_destroy (&(lp->cond));
+    }
+    safe_free(lp->filename);
+    safe_free(lp->handles);
+    safe_free(lp->header);
+    safe_free(lp->bufs[0].recs);
+    safe_free(lp->bufs[1].recs);
+    lp->in_use = 0;
+
+    errno = err;
+}
+
+//// Subsystem operation /////////////////////////////////////////////
+
+/* Channels unregistered from callbacks are only marked "dying" (and
+   skipped); they are released when the outermost dispatch returns, so
+   that no loop or cycle callback sees freed slots.  If that dispatch is
+   a cda callback, releasing might delete its very server (or bigc
+   connection), so then it is done from a zero-delay timeout instead. */
+
+static int  dispatch_depth    = 0;
+static int  deferred_releases = 0;
+static int  in_cda_callback   = 0;
+static int  reap_scheduled    = 0;
+
+static void ReapDeferred(void);
+
+static void ReapTout(int uniq __attribute__((unused)), void *privptr1 __attribute__((unused)),
+                     sl_tid_t tid __attribute__((unused)), void *privptr2 __attribute__((unused)))
+{
+  SIMPLE_LOCKED();
+
+    reap_scheduled = 0;
+    if (dispatch_depth == 0  &&  deferred_releases > 0) ReapDeferred();
+}
+
+static void DispatchEnter(void)
+{
+    dispatch_depth++;
+}
+
+static void DispatchLeave(void)
+{
+    if (--dispatch_depth > 0  ||  deferred_releases == 0) return;
+
+    if (!in_cda_callback)
+        ReapDeferred();
+    /* On failure the next dispatch will retry */
+    else if (!reap_scheduled  &&
+             sl_enq_tout_after(0, NULL, 0, ReapTout, NULL) >= 0)
+        reap_scheduled = 1;
+}
+
+static void FillLocalreginfo(simplesubsys_t *syp, cda_localreginfo_t *lrp)
+{
+    lrp->count       = syp->numlocalregs;
+    lrp->regs        = syp->localregs;
+    lrp->regsinited  = syp->localregsinited;
+}
+
+/* Resizes local registers, keeping values of the retained ones;
+   on failure the old ones are left intact */
+static int ResizeLocalregs(simplesubsys_t *syp, int count)
+{
+  double *new_regs;
+  char   *new_inited;
+  int     keep;
+
+    new_regs   = malloc(count * sizeof(*new_regs));
+    new_inited = malloc(count * sizeof(*new_inited));
+    if (count != 0  &&  (new_regs == NULL  ||  new_inited == NULL))
+    {
+        safe_free(new_regs);
+        safe_free(new_inited);
+        return -1;
+    }
+
+    keep = count < syp->numlocalregs? count : syp->numlocalregs;
+    if (keep > 0)
+    {
+        memcpy(new_regs,   syp->localregs,       keep * sizeof(*new_regs));
+        memcpy(new_inited, syp->localregsinited, keep * sizeof(*new_inited));
+    }
+    if (count > keep)
+    {
+        bzero(new_regs   + keep, (count - keep) * sizeof(*new_regs));
+        bzero(new_inited + keep, (count - keep) * sizeof(*new_inited));
+    }
+
+    safe_free(syp->localregs);
+    safe_free(syp->localregsinited);
+    syp->localregs       = new_regs;
+    syp->localregsinited = new_inited;
+    syp->numlocalregs    = count;
+
+    return 0;
+}
+
+/* Raises *numregs_p to cover registers the formula addresses directly;
+   a computed register number sets *computed_p */
+static void FormulaRegsNeeded(excmd_t *f, int *numregs_p, int *computed_p)
+{
+  int  op;
+  int  r;
+
+    if (f == NULL) return;
+
+    for (;  (op = f->cmd & OP_code) != OP_RET;  f++)
+    {
+        if (op != OP_GETLCLREG  &&  op != OP_SETLCLREG) continue;
+
+        if ((f->cmd & OP_imm) == 0)
+        {
+            *computed_p = 1;
+            continue;
+        }
+        r = (int)(f->arg.number);
+        if (r >= *numregs_p) *numregs_p = r + 1;
+    }
+}
+
+static void ElemRegsNeeded(ElemInfo ei, int *numregs_p, int *computed_p)
+{
+  int     n;
+  Knob    k;
+
+    for (n = 0, k = ei->content;  n < ei->count;  n++, k++)
+    {
+        FormulaRegsNeeded(k->formula,    numregs_p, computed_p);
+        FormulaRegsNeeded(k->revformula, numregs_p, computed_p);
+        FormulaRegsNeeded(k->colformula, numregs_p, computed_p);
+
+        if (k->type == LOGT_SUBELEM  &&  k->subelem != NULL)
+            ElemRegsNeeded(k->subelem, numregs_p, computed_p);
+    }
+}
+
+/* Sizes local registers by what the description's formulas address,
+   unless the count was set explicitly */
+static int SizeSubsysLocalregs(simplesubsys_t *syp)
+{
+  groupelem_t    *gep;
+  int             numregs  = 0;
+  int             computed = 0;
+
+    if (syp->localregs_set) return 0;
+
+    for (gep = syp->grouplist;  gep->ei != NULL;  gep++)
+        ElemRegsNeeded(gep->ei, &numregs, &computed);
+    if (computed  &&  numregs < NUMLOCALREGS) numregs = NUMLOCALREGS;
+
+    return ResizeLocalregs(syp, numregs);
+}
+
+/* Returns nonzero if the channel's value/rflags differ from what was
+   seen on the previous cycle, and remembers the current ones */
+static int ChanChanged(simplechan_t *scp)
+{
+  double    v      = scp->k->curv;
+  rflags_t  rflags = scp->k->currflags;
+  int       same;
+
+    same = scp->have_last                 &&
+           rflags == scp->last_rflags     &&
+           (v == scp->last_v  ||  (isnan(v)  &&  isnan(scp->last_v)));
+
+    scp->have_last   = 1;
+    scp->last_v      = v;
+    scp->last_rflags = rflags;
+
+    return !same;
+}
+
+static double SimpleMonotime(void)
+{
+  struct timespec  now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec / 1000000000.0;
+}
+
+static int ChanHasFilter(simplechan_t *scp)
+{
+    return scp->min_interval > 0  ||
+           scp->deadband_abs > 0  ||  scp->deadband_rel > 0;
+}
+
+/* Decides whether an update which passed the dispatch-mode check
+   ('fresh') or a held rate-limited one is delivered.  Deadband is
+   measured from the last *delivered* value; a rate-limited update is
+   kept pending and the then-latest value is delivered on the first
+   cycle after the interval expires.  *now_p<0 means "not fetched yet" */
+static int ChanFilterPass(simplechan_t *scp, int fresh, double *now_p)
+{
+  double    v      = scp->k->curv;
+  rflags_t  rflags = scp->k->currflags;
+  double    d;
+
+    if (!ChanHasFilter(scp)) goto DELIVER;
+
+    if ((scp->deadband_abs > 0  ||  scp->deadband_rel > 0)  &&
+        scp->have_sent  &&  rflags == scp->sent_rflags      &&
+        !isnan(v)       &&  !isnan(scp->sent_v))
+    {
+        d = fabs(v - scp->sent_v);
+        if (d <= scp->deadband_abs  ||  d <= scp->deadband_rel * fabs(scp->sent_v))
+        {
+            scp->filter_pending = 0;
+            if (fresh) scp->n_suppressed++;
+            return 0;
+        }
+    }
+
+    if (scp->min_interval > 0)
+    {
+        if (*now_p < 0) *now_p = SimpleMonotime();
+        if (scp->have_sent  &&  *now_p - scp->sent_time < scp->min_interval)
+        {
+            scp->filter_pending = 1;
+            if (fresh) scp->n_suppressed++;
+            return 0;
+        }
+        scp->sent_time = *now_p;
+    }
+
+ DELIVER:
+    scp->filter_pending = 0;
+    scp->have_sent      = 1;
+    scp->sent_v         = v;
+    scp->sent_rflags    = rflags;
+    scp->n_delivered++;
+
+    return 1;
+}
+
+static void HistoryPush(simplechan_t *scp, double timestamp)
+{
+  int  n;
+
+    if (scp->hist_used < scp->hist_size)
+        n = scp->hist_first + scp->hist_used++;
+    else
+        n = scp->hist_first++;
+    if (n              >= scp->hist_size) n               -= scp->hist_size;
+    if (scp->hist_first >= scp->hist_size) scp->hist_first -= scp->hist_size;
+
+    scp->hist_vals [n] = scp->k->curv;
+    scp->hist_times[n] = timestamp;
+}
+
+static void LogAppend(simplelog_t *lp, int cid, double val, int rflags, double timestamp)
+{
+  logbuf_t             *bp;
+  CdrSimpleLogRecord_t *rp;
+
+    pthread_mutex_lock(&(lp->mutex));
+    bp = lp->bufs + lp->fill;
+    /* Both buffers are full: the writer lags behind, so drop rather than block */
+    if (bp->count >= SIMPLELOG_BUF_RECS)
+        lp->dropped++;
+    else
+    {
+        rp = bp->recs + bp->count++;
+        rp->timestamp = timestamp;
+        rp->value     = val;
+        rp->handle    = cid;
+        rp->rflags    = rflags;
+        if (bp->count == SIMPLELOG_BUF_RECS) pthread_cond_signal(&(lp->cond));
+    }
+    pthread_mutex_unlock(&(lp->mutex));
+}
+
+/* Makes per-cycle arrays large enough to hold all subsystem's channels */
+static int GrowCycleBufs(simplesubsys_t *syp)
+{
+  int     new_allocd;
+  int    *new_handles;
+  double *new_vals;
+  int    *new_rflags;
+
+    if (syp->nchans <= syp->cycle_allocd) return 0;
+
+    new_allocd = syp->cycle_allocd == 0? 16 : syp->cycle_allocd;
+    while (new_allocd < syp->nchans) new_allocd *= 2;
+
+    if ((new_handles = realloc(syp->cycle_handles, new_allocd * sizeof(*new_handles))) == NULL)
+        return -1;
+    syp->cycle_handles = new_handles;
+    if ((new_vals    = realloc(syp->cycle_vals,    new_allocd * sizeof(*new_vals)))    == NULL)
+        return -1;
+    syp->cycle_vals    = new_vals;
+    if ((new_rflags  = realloc(syp->cycle_rflags,  new_allocd * sizeof(*new_rflags)))  == NULL)
+        return -1;
+    syp->cycle_rflags  = new_rflags;
+
+    syp->cycle_allocd = new_allocd;
+
+    return 0;
+}
+
+/* PROCESS_REGISTERED mode evaluates only knobs of registered channels,
+   explicit dependencies and their closure via local registers: a knob
+   whose formula writes a register read by a needed knob is needed too.
+   Formulas are scanned up to the first RET (a register accessed past it
+   via GOTO needs an explicit dependency); a computed register number
+   means "any".  Knobs are evaluated as runs of adjacent ones in grouplist
+   order, so that writers still precede readers.  Runs are rebuilt on
+   the first cycle after the set changes. */
+
+static int knobptr_compare(const void *a, const void *b)
+{
+  uintptr_t  ka = (uintptr_t)(*(const Knob *)a);
+  uintptr_t  kb = (uintptr_t)(*(const Knob *)b);
+
+    return ka < kb? -1 : ka > kb;
+}
+
+static int AppendKnobRun(simplesubsys_t *syp, Knob k)
+{
+  knobrun_t  *rp;
+  knobrun_t  *new_runs;
+  int         new_allocd;
+
+    rp = syp->lazy_runs + syp->lazy_runs_count - 1;
+    if (syp->lazy_runs_count > 0  &&  rp->k + rp->n == k)
+    {
+        rp->n++;
+        return 0;
+    }
+
+    if (syp->lazy_runs_count >= syp->lazy_runs_allocd)
+    {
+        new_allocd = syp->lazy_runs_allocd == 0? 16 : syp->lazy_runs_allocd * 2;
+        new_runs   = realloc(syp->lazy_runs, new_allocd * sizeof(*new_runs));
+        if (new_runs == NULL) return -1;
+        syp->lazy_runs        = new_runs;
+        syp->lazy_runs_allocd = new_allocd;
+    }
+    rp = syp->lazy_runs + syp->lazy_runs_count++;
+    rp->k = k;
+    rp->n = 1;
+
+    return 0;
+}
+
+static int CollectKnobRuns(simplesubsys_t *syp, ElemInfo ei,
+                           Knob *needed, int needed_count)
+{
+  int     n;
+  Knob    k;
+
+    for (n = 0, k = ei->content;  n < ei->count;  n++, k++)
+    {
+        if (bsearch(&k, needed, needed_count, sizeof(*needed), knobptr_compare) != NULL  &&
+            AppendKnobRun(syp, k) != 0)
+            return -1;
+
+        if (k->type == LOGT_SUBELEM  &&  k->subelem != NULL  &&
+            CollectKnobRuns(syp, k->subelem, needed, needed_count) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+typedef struct
+{
+    Knob   *needed;     // [0..sorted) sorted, then knobs added by this pass
+    int     sorted;
+    int     count;
+    char   *regs;       // [numregs], read by needed knobs
+    int     numregs;
+    int     all_regs;   // Some needed knob reads a computed register
+    int     added;
+} lazyclosure_t;
+
+static int KnobIsNeeded(lazyclosure_t *lc, Knob k)
+{
+    return bsearch(&k, lc->needed, lc->sorted, sizeof(*(lc->needed)),
+                   knobptr_compare) != NULL;
+}
+
+/* mark!=0: marks registers read by formula; else returns whether it
+   writes any of the marked ones */
+static int ScanFormulaRegs(excmd_t *f, int mark, lazyclosure_t *lc)
+{
+  int  op;
+  int  r;
+
+    if (f == NULL) return 0;
+
+    for (;  (op = f->cmd & OP_code) != OP_RET;  f++)
+    {
+        if (op != (mark? OP_GETLCLREG : OP_SETLCLREG)) continue;
+
+        r = (f->cmd & OP_imm)? (int)(f->arg.number) : -1;
+        if (mark)
+        {
+            if (r >= 0  &&  r < lc->numregs) lc->regs[r] = 1;
+            else                             lc->all_regs = 1;
+        }
+        else if (r < 0  ||  lc->all_regs  ||  (r < lc->numregs  &&  lc->regs[r]))
+            return 1;
+    }
+
+    return 0;
+}
+
+/* mark!=0: marks registers read by needed knobs; else adds their writers */
+static void ClosureElemPass(lazyclosure_t *lc, ElemInfo ei, int mark)
+{
+  int     n;
+  Knob    k;
+
+    for (n = 0, k = ei->content;  n < ei->count;  n++, k++)
+    {
+        if (mark)
+        {
+            if (KnobIsNeeded(lc, k))
+            {
+                ScanFormulaRegs(k->formula,    1, lc);
+                ScanFormulaRegs(k->colformula, 1, lc);
+            }
+        }
+        else if (!KnobIsNeeded(lc, k)  &&
+                 (ScanFormulaRegs(k->formula,    0, lc)  ||
+                  ScanFormulaRegs(k->colformula, 0, lc)))
+        {
+            lc->needed[lc->count++] = k;
+            lc->added++;
+        }
+
+        if (k->type == LOGT_SUBELEM  &&  k->subelem != NULL)
+            ClosureElemPass(lc, k->subelem, mark);
+    }
+}
+
+static int CountElemKnobs(ElemInfo ei)
+{
+  int     n;
+  Knob    k;
+  int     count;
+
+    for (n = 0, k = ei->content, count = ei->count;  n < ei->count;  n++, k++)
+        if (k->type == LOGT_SUBELEM  &&  k->subelem != NULL)
+            count += CountElemKnobs(k->subelem);
+
+    return count;
+}
+
+static int RebuildLazyRuns(simplesubsys_t *syp)
+{
+  lazyclosure_t   lc;
+  int             total;
+  int             cid;
+  simplechan_t   *scp;
+  groupelem_t    *gep;
+  int             n;
+  int             r = 0;
+
+    for (gep = syp->grouplist, total = 0;  gep->ei != NULL;  gep++)
+        total += CountElemKnobs(gep->ei);
+
+    bzero(&lc, sizeof(lc));
+    lc.numregs = syp->numlocalregs;
+    lc.needed  = malloc((syp->nchans + syp->deps_count + total + 1) * sizeof(*(lc.needed)));
+    lc.regs    = calloc(lc.numregs + 1, sizeof(*(lc.regs)));
+    if (lc.needed == NULL  ||  lc.regs == NULL)
+    {
+        safe_free(lc.needed);
+        safe_free(lc.regs);
+        return -1;
+    }
+
+    for (cid = syp->frs_cid;  cid >= 0;  cid = scp->nxt_cid)
+    {
+        scp = AccessSmplchSlot(cid);
+        lc.needed[lc.count++] = scp->k;
+    }
+    for (n = 0;  n < syp->deps_count;  n++) lc.needed[lc.count++] = syp->deps[n].k;
+
+    /* Until no more writers of needed registers appear */
+    do
+    {
+        qsort(lc.needed, lc.count, sizeof(*(lc.needed)), knobptr_compare);
+        lc.sorted = lc.count;
+        lc.added  = 0;
+        for (gep = syp->grouplist;  gep->ei != NULL;  gep++)
+            ClosureElemPass(&lc, gep->ei, 1);
+        for (gep = syp->grouplist;  gep->ei != NULL;  gep++)
+            ClosureElemPass(&lc, gep->ei, 0);
+    }
+    while (lc.added > 0);
+
+    syp->lazy_runs_count = 0;
+    for (gep = syp->grouplist;  gep->ei != NULL  &&  r == 0;  gep++)
+        r = CollectKnobRuns(syp, gep->ei, lc.needed, lc.count);
+
+    free(lc.needed);
+    free(lc.regs);
+    if (r == 0) syp->lazy_dirty = 0;
+
+    return r;
+}
+
+static void ProcessSubsys(simplesubsys_t *syp, int reason,
+                          cda_localreginfo_t *lrp)
+{
+  int  n;
+
+    if (syp->process_mode == CDR_SIMPLE_PROCESS_REGISTERED)
+    {
+        if (!syp->lazy_dirty  ||  RebuildLazyRuns(syp) == 0)
+        {
+            for (n = 0;  n < syp->lazy_runs_count;  n++)
+                CdrProcessKnobs(reason, 0, NULL, lrp,
+                                syp->lazy_runs[n].k, syp->lazy_runs[n].n);
+            return;
+        }
+        reporterror("%s: unable to rebuild knob runs of \"%s\", processing all",
+                    __FUNCTION__, syp->subsysname);
+    }
+
+    CdrProcessGrouplist(reason, 0, NULL, lrp, syp->grouplist);
+}
+
+/* Async writes: a channel is queued to its subsystem's list once, with
+   later requests just replacing the value; after the subsystem's cycle
+   (or on explicit flush) the list is written out in one go -- still a
+   CdrSetKnobValue() per channel, what's saved is the coalescing */
+
+static CdrSimpleWriteCB_t  write_cb         = NULL;
+static void               *write_cb_privptr = NULL;
+
+static void QueueWrite(simplesubsys_t *syp, int cid, double val)
+{
+  simplechan_t   *scp = AccessSmplchSlot(cid);
+
+    scp->write_v = val;
+    if (scp->write_pending) return;
+
+    scp->write_pending = 1;
+    scp->nxt_wcid      = -1;
+    if (syp->lst_wcid < 0) syp->frs_wcid = cid;
+    else                   AccessSmplchSlot(syp->lst_wcid)->nxt_wcid = cid;
+    syp->lst_wcid = cid;
+}
+
+static void CancelWrite(simplesubsys_t *syp, int cid)
+{
+  simplechan_t   *scp = AccessSmplchSlot(cid);
+  int            *np;
+  int             prv;
+
+    if (!scp->write_pending) return;
+
+    for (np = &(syp->frs_wcid), prv = -1;
+         *np >= 0  &&  *np != cid;
+         prv = *np, np = &(AccessSmplchSlot(*np)->nxt_wcid));
+    /* Note: FlushSubsysWrites() clears write_pending of a detached batch
+       before writing, so a pending channel is always on the list */
+    if (*np == cid)
+    {
+        *np = scp->nxt_wcid;
+        if (syp->lst_wcid == cid) syp->lst_wcid = prv;
+    }
+    scp->write_pending = 0;
+}
+
+typedef struct
+{
+    int     cid;
+    double  v;
+    int     err;
+} writeitem_t;
+
+enum {WRITEBATCH_STACK = 64};  // Batches up to this size need no malloc()
+
+static void FlushSubsysWrites(simplesubsys_t *syp)
+{
+  cda_localreginfo_t  localreginfo;
+  writeitem_t         stack_items[WRITEBATCH_STACK];
+  writeitem_t        *items = stack_items;
+  int                 count;
   int                 cid;
+  int                 i;
   simplechan_t       *scp;
+  int                 nqueued = 0;
+
+    if (syp->frs_wcid < 0) return;
+
+    for (cid = syp->frs_wcid, count = 0;  cid >= 0;  cid = AccessSmplchSlot(cid)->nxt_wcid)
+        count++;
+    if (count > WRITEBATCH_STACK  &&
+        (items = malloc(count * sizeof(*items))) == NULL)
+    {
+        /* Leave the list queued, the next flush will retry */
+        reporterror("%s: unable to allocate %d write items", __FUNCTION__, count);
+        return;
+    }
+
+    /* Detach the batch and take it out of the "pending" state before any
+       user code runs: writes requested from callbacks go to the next batch,
+       and a direct Set from a callback can't find a stale list */
+    for (cid = syp->frs_wcid, count = 0;  cid >= 0;  cid = scp->nxt_wcid)
+    {
+        scp = AccessSmplchSlot(cid);
+        scp->write_pending = 0;
+        if (scp->dying) continue;
+        items[count].cid = cid;
+        items[count].v   = scp->write_v;
+        count++;
+    }
+    syp->frs_wcid = syp->lst_wcid = -1;
+
+    /* All writes first, so that a Set from a completion callback isn't
+       overridden by an older async value of the same batch */
+    FillLocalreginfo(syp, &localreginfo);
+    for (i = 0;  i < count;  i++)
+    {
+        items[i].err = 0;
+        errno = 0;
+        if (CdrSetKnobValue(AccessSmplchSlot(items[i].cid)->k, items[i].v,
+                            0, &localreginfo) != 0)
+            items[i].err = errno != 0? errno : EIO;
+    }
+
+    for (i = 0;  i < count;  i++)
+    {
+        if (simple_threaded)
+        {
+            QueueUpdate(CDR_SIMPLE_UPD_WRITE, items[i].cid, items[i].v, items[i].err,
+                        SimpleTimestamp());
+            nqueued++;
+            continue;
+        }
+        /* A callback may have unregistered a later channel */
+        scp = AccessSmplchSlot(items[i].cid);
+        if (write_cb != NULL  &&  scp->in_use  &&  !scp->dying)
+            write_cb(items[i].cid, items[i].v, items[i].err, write_cb_privptr);
+    }
+
+    if (nqueued > 0) UpdQueueSignal();
+    if (items != stack_items) free(items);
+}
+
+static void EventProc(cda_serverid_t sid __attribute__((unused)), int reason, void *privptr)
+{
+  int                 yid  = ptr2lint(privptr);
+  simplesubsys_t     *syp = AccessSubsysSlot(yid);
+  cda_localreginfo_t  localreginfo;
+
+  int                 cid;
+  simplechan_t       *scp;
+  int                 n;
+  int                 mode;
+  int                 changed;
+  int                 fresh;
+  double              now;
+  int                 collect;
+  int                 ncollected;
+  int                 nqueued;
+  double              timestamp;
+  CdrSimpleSubsysPerf_t *syperf;
+  CdrSimpleChanPerf_t   *chperf;
+  uint64_t            t0 = 0;
+
+    in_cda_callback++;
+    DispatchEnter();
+
+    FillLocalreginfo(syp, &localreginfo);
+
+    syperf = PerfOf((void **)&(syp->perf), sizeof(*syperf));
+    if (syperf != NULL) t0 = PerfNow();
+    ProcessSubsys(syp, reason, &localreginfo);
+    if (syperf != NULL)
+    {
+        syperf->events++;
+        HistRecord(&(syperf->process_time), PerfNow() - t0);
+    }
+
+    /* In threaded mode updates go to the queue instead of callbacks */
+    timestamp = simple_threaded? SimpleTimestamp() : 0;
+    nqueued   = 0;
+    now       = -1;
+
+    collect = syp->cycle_cb != NULL  &&  !simple_threaded;
+    if (collect  &&  GrowCycleBufs(syp) != 0)
+    {
+        reporterror("%s: unable to grow cycle buffers of \"%s\"",
+                    __FUNCTION__, syp->subsysname);
+        collect = 0;
+    }
+    ncollected = 0;
+
+    for (cid = syp->frs_cid;
+         cid >= 0;
+         cid = scp->nxt_cid)
+    {
+        scp = AccessSmplchSlot(cid);
+        if (scp->dying) continue;
+        /* History records every cycle, regardless of dispatch/filters */
+        if (scp->hist_size > 0)
+        {
+            if (timestamp == 0) timestamp = SimpleTimestamp();
+            HistoryPush(scp, timestamp);
+        }
+        if (scp->log_ids_count > 0)
+        {
+            if (timestamp == 0) timestamp = SimpleTimestamp();
+            for (n = 0;  n < scp->log_ids_count;  n++)
+                LogAppend(AccessSimplelogSlot(scp->log_ids[n]), cid,
+                          scp->k->curv, scp->k->currflags, timestamp);
+        }
+        if (scp->cb == NULL  &&  !collect  &&  !simple_threaded) continue;
+
+        mode = scp->dispatch_mode;
+        if (mode == CDR_SIMPLE_DISPATCH_INHERIT) mode = syp->dispatch_mode;
+
+        /* Note: ChanChanged() must be called in any mode, to keep "last" current */
+        changed = ChanChanged(scp);
+        fresh   = changed  ||  mode != CDR_SIMPLE_DISPATCH_ONCHANGE;
+        if (!fresh  &&  !scp->filter_pending) continue;
+        if (!ChanFilterPass(scp, fresh, &now)) continue;
+
+        if (simple_threaded)
+        {
+            QueueUpdate(CDR_SIMPLE_UPD_CHAN, cid,
+                        scp->k->curv, scp->k->currflags, timestamp);
+            nqueued++;
+            continue;
+        }
+        if (collect)
+        {
+            syp->cycle_handles[ncollected] = cid;
+            syp->cycle_vals   [ncollected] = scp->k->curv;
+            syp->cycle_rflags [ncollected] = scp->k->currflags;
+            ncollected++;
+        }
+        if (scp->cb != NULL)
+        {
+            chperf = PerfOf((void **)&(scp->perf), sizeof(*chperf));
+            if (chperf != NULL) t0 = PerfNow();
+            scp->cb(cid, scp->k->curv, scp->privptr);
+            if (chperf != NULL)
+            {
+                chperf->callbacks++;
+                HistRecord(&(chperf->cb_time), PerfNow() - t0);
+            }
+        }
+    }
+
+    if (nqueued > 0) UpdQueueSignal();
+
+    if (collect  &&  ncollected > 0)
+        syp->cycle_cb(ncollected,
+                      syp->cycle_handles, syp->cycle_vals, syp->cycle_rflags,
+                      syp->cycle_privptr);
+
+    /* Writes, including those just requested by callbacks */
+    FlushSubsysWrites(syp);
+
+    DispatchLeave();
+    in_cda_callback--;
+}
+
+//// Knob name index ///////////////////////////////////////////////
+
+static const char *knob_idx_getname(void *privptr, int n)
+{
+    return AccessSubsysSlot(ptr2lint(privptr))->knobs[n].name;
+}
+
+/* Adds name->k, unless such name is already known (first one wins,
+   as with a tree walk) */
+static int AddKnobRef(int yid, const char *name, Knob k)
+{
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  knobref_t      *new_knobs;
+  int             new_allocd;
+  int             n;
+
+    if (NameIdxFind(&(syp->knob_idx), name) >= 0) return 0;
+
+    if (syp->knobs_count >= syp->knobs_allocd)
+    {
+        new_allocd = syp->knobs_allocd == 0? 64 : syp->knobs_allocd * 2;
+        new_knobs  = realloc(syp->knobs, new_allocd * sizeof(*new_knobs));
+        if (new_knobs == NULL) return -1;
+        syp->knobs        = new_knobs;
+        syp->knobs_allocd = new_allocd;
+    }
+
+    n = syp->knobs_count;
+    if ((syp->knobs[n].name = strdup(name)) == NULL) return -1;
+    syp->knobs[n].k = k;
+    if (NameIdxAdd(&(syp->knob_idx), n) != 0)
+    {
+        safe_free(syp->knobs[n].name);
+        return -1;
+    }
+    syp->knobs_count++;
+
+    return 0;
+}
+
+/* Every knob is indexed by its full dotted path and by its bare ident */
+static int IndexElemKnobs(int yid, ElemInfo ei, const char *prefix)
+{
+  char    path[1000];
+  size_t  prefixlen;
+  int     n;
+  Knob    k;
+
+    if (ei->ident != NULL  &&  ei->ident[0] != '\0')
+    {
+        if (prefix[0] != '\0')
+            snprintf(path, sizeof(path), "%s.%s", prefix, ei->ident);
+        else
+            strzcpy(path, ei->ident, sizeof(path));
+    }
+    else
+        strzcpy(path, prefix, sizeof(path));
+    prefixlen = strlen(path);
+
+    for (n = 0, k = ei->content;  n < ei->count;  n++, k++)
+    {
+        if (k->ident == NULL  ||  k->ident[0] == '\0') continue;
+
+        snprintf(path + prefixlen, sizeof(path) - prefixlen,
+                 "%s%s", prefixlen != 0? "." : "", k->ident);
+        if (AddKnobRef(yid, path,     k) != 0  ||
+            AddKnobRef(yid, k->ident, k) != 0)
+            return -1;
+        path[prefixlen] = '\0';
+
+        if (k->type == LOGT_SUBELEM  &&  k->subelem != NULL  &&
+            IndexElemKnobs(yid, k->subelem, path) != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+static int BuildKnobIndex(int yid)
+{
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  groupelem_t    *gep;
+
+    syp->knob_idx.getname = knob_idx_getname;
+    syp->knob_idx.privptr = lint2ptr(yid);
+
+    for (gep = syp->grouplist;  gep->ei != NULL;  gep++)
+        if (IndexElemKnobs(yid, gep->ei, "") != 0) return -1;
+
+    return 0;
+}
+
+/* Resolves a knob via index; names not found there (e.g. some
+   datatree-specific spelling) are looked up the old way and remembered */
+static Knob FindSubsysKnob(int yid, const char *k_name)
+{
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  int             n;
+  Knob            k;
+
+    n = NameIdxFind(&(syp->knob_idx), k_name);
+    if (n >= 0) return syp->knobs[n].k;
+
+    k = datatree_FindNode(syp->grouplist, k_name);
+    if (k != NULL) AddKnobRef(yid, k_name, k);
+
+    return k;
+}
+
+static int AllocSubsysSlot(const char *subsysname, const char *caller)
+{
+  int             yid;
+  simplesubsys_t *syp;
+
+    yid = GetSubsysSlot();
+    if (yid < 0)
+    {
+        reporterror("%s: unable to allocate subsys-slot", caller);
+        return -1;
+    }
+    syp = AccessSubsysSlot(yid);
+    strzcpy(syp->subsysname, subsysname, sizeof(syp->subsysname));
+    if (NameIdxAdd(&subsys_idx, yid) != 0)
+    {
+        reporterror("%s: unable to index subsys-slot", caller);
+        syp->in_use = 0;
+        return -1;
+    }
+    syp->mainsid = CDA_SERVERID_ERROR;
+    syp->frs_cid = -1;
+    syp->frs_bid = -1;
+    syp->frs_wcid = syp->lst_wcid = -1;
+    syp->dispatch_mode = CDR_SIMPLE_DISPATCH_ALWAYS;
+
+    return yid;
+}
+
+/* Makes a subsystem with opened description alive; drops it on error */
+static int ActivateSubsys(int yid, const char *caller)
+{
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  int             n;
+
+    syp->mainsid = cda_new_server(syp->info->defserver,
+                                  EventProc, lint2ptr(yid),
+                                  CDA_REGULAR);
+    if (syp->mainsid == CDA_SERVERID_ERROR)
+    {
+        reporterror("%s: cda_new_server(\"%s\"): %s",
+                    caller, syp->info->defserver, cx_strerror(errno));
+        goto ERREXIT;
+    }
+    if (syp->info->phys_info_count < 0)
+    {
+        cda_TMP_register_physinfo_dbase((physinfodb_rec_t *)(syp->info->phys_info));
+    }
+    else
+    {
+        cda_TMP_register_physinfo_dbase(NULL);
+        cda_set_physinfo(syp->mainsid, syp->info->phys_info, syp->info->phys_info_count);
+    }
+    syp->grouplist = CdrCvtGroupunits2Grouplist(syp->mainsid, syp->info->grouping);
+    if (syp->grouplist == NULL)
+    {
+        reporterror("%s: CdrCvtGroupunits2Grouplist(): %s",
+                    caller, cx_strerror(errno));
+        goto ERREXIT;
+    }
+    if (BuildKnobIndex(yid) != 0)
+    {
+        reporterror("%s: BuildKnobIndex(\"%s\"): %s",
+                    caller, syp->subsysname, cx_strerror(errno));
+        goto ERREXIT;
+    }
+    if (SizeSubsysLocalregs(syp) != 0)
+    {
+        reporterror("%s: unable to allocate local registers for \"%s\"",
+                    caller, syp->subsysname);
+        errno = ENOMEM;
+        goto ERREXIT;
+    }
+    /* Dependencies kept from a previous load */
+    for (n = 0;  n < syp->deps_count;  n++)
+        if ((syp->deps[n].k = FindSubsysKnob(yid, syp->deps[n].name)) == NULL)
+        {
+            reporterror("%s: dependency \"%s\" not found in \"%s\"",
+                        caller, syp->deps[n].name, syp->subsysname);
+            errno = ENOENT;
+            goto ERREXIT;
+        }
+
+    cda_run_server(syp->mainsid);
+
+    return 0;
+
+ ERREXIT:
+    DropSubsys(yid);
+
+    return -1;
+}
+
+static int SubsysLoaded(int yid)
+{
+    return AccessSubsysSlot(yid)->mainsid != CDA_SERVERID_ERROR;
+}
+
+static int GetSubsysID(const char *argv0,
+                       const char *caller,
+                       const char *subsysname)
+{
+  int             yid;
+  simplesubsys_t *syp;
+  char           *err;
+
+    /* Check if this subsystem is already loaded (or just unloaded) */
+    yid = NameIdxFind(&subsys_idx, subsysname);
+    if (yid >= 0  &&  SubsysLoaded(yid)) return yid;
+
+    /* No, should load... */
+
+    /* First, allocate (unless there's a slot with settings)... */
+    if (yid < 0) yid = AllocSubsysSlot(subsysname, caller);
+    if (yid < 0) return -1;
+    syp = AccessSubsysSlot(yid);
+
+    /* ...than open... */
+    if (CdrOpenDescription(subsysname, argv0, &(syp->handle), &(syp->info), &err) != 0)
+    {
+        reporterror("%s: OpenDescription(\"%s\"): %s",
+                    caller, subsysname, err);
+        DropSubsys(yid);
+        return -1;
+    }
+    /* ...and use */
+    if (ActivateSubsys(yid, caller) != 0) return -1;
+
+    return yid;
+}
+
+//// Subsystems preloading ///////////////////////////////////////////
+
+/* A batch of loads, done serially: CdrOpenDescription() isn't
+   thread-safe (dlopen()/dlerror(), descriptions' own initialization,
+   shared error buffer), and the rest (cda servers, grouplist conversion,
+   index) isn't either */
+int   CdrSimplePreloadSubsystems(const char **names, int count, const char *argv0,
+                                 int *errs)
+{
+  SIMPLE_LOCKED();
+  int             n;
+  int             e;
+  int             nloaded;
+
+    if (names == NULL  ||  count < 0)
+    {
+        reporterror("%s: NULL names or negative count", __FUNCTION__);
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (n = 0, nloaded = 0;  n < count;  n++)
+    {
+        if (names[n] == NULL  ||  names[n][0] == '\0')
+            e = EINVAL;
+        else
+        {
+            errno = 0;
+            e = GetSubsysID(argv0, __FUNCTION__, names[n]) >= 0? 0
+                : errno != 0? errno : ENOENT;
+        }
+        if (e == 0) nloaded++;
+        if (errs != NULL) errs[n] = e;
+    }
+
+    return nloaded;
+}
+
+//// Registration helpers ////////////////////////////////////////////
+
+/* Checks a "SUBSYS.KNOB" name and splits it into parts.
+   On error reports it, sets errno and returns -1 */
+static int SplitChanName(const char *name, const char *caller, const char *what,
+                         char *subsysname, size_t subsysname_size,
+                         const char **k_name_p)
+{
+  const char *dot_p;
+  size_t      subsysnamelen;
+
+    /* Perform checks */
+    if (name == NULL)
+    {
+        reporterror("%s: NULL %s request", caller, what);
+        errno = EINVAL;
+        return -1;
+    }
+    if (*name == '\0')
+    {
+        reporterror("%s: empty %s request", caller, what);
+        errno = EINVAL;
+        return -1;
+    }
+    dot_p = strchr(name, '.');
+    if (dot_p == NULL)
+    {
+        reporterror("%s: '.'-less %s request \"%s\"", caller, what, name);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* Obtain subsys name */
+    subsysnamelen = dot_p - name;
+    if (subsysnamelen > subsysname_size - 1)
+        subsysnamelen = subsysname_size - 1;
+    memcpy(subsysname, name, subsysnamelen); subsysname[subsysnamelen] = '\0';
+
+    *k_name_p = dot_p + 1;
+
+    return 0;
+}
+
+static Knob FindChanKnob(int yid, const char *name, const char *k_name,
+                         const char *caller)
+{
+  Knob  k;
+
+    k = FindSubsysKnob(yid, k_name);
+    if (k == NULL)
+    {
+        reporterror("%s: node \"%s\" not found",
+                    caller, name);
+        errno = ENOENT;
+        return NULL;
+    }
+    if (k->type == LOGT_SUBELEM)
+    {
+        reporterror("%s: attempt to use subelem (\"%s\")",
+                    caller, name);
+        errno = EINVAL;
+        return NULL;
+    }
+
+    return k;
+}
+
+/* Batch registration: names are grouped by subsystem, so that each
+   subsystem is looked up (and, if required, loaded) only once */
+
+typedef int (*batch_adder_t)(int yid, const char *name, const char *k_name,
+                             int n, void *privptr, const char *caller);
+
+typedef struct
+{
+    const char *name;
+    const char *k_name;
+    size_t      subsysnamelen;
+    int         n;             // Index in caller's arrays
+} batchitem_t;
+
+static int batchitem_prefixcmp(const batchitem_t *a, const batchitem_t *b)
+{
+  size_t  len = a->subsysnamelen < b->subsysnamelen? a->subsysnamelen
+                                                   : b->subsysnamelen;
+  int     r;
+
+    r = strncasecmp(a->name, b->name, len);
+    if (r == 0)
+        r = (a->subsysnamelen > b->subsysnamelen) -
+            (a->subsysnamelen < b->subsysnamelen);
+
+    return r;
+}
+
+static int batchitem_compare(const void *a, const void *b)
+{
+  const batchitem_t *ia = a;
+  const batchitem_t *ib = b;
+  int                r;
+
+    r = batchitem_prefixcmp(ia, ib);
+    /* Preserve caller's order inside a subsystem */
+    if (r == 0) r = ia->n - ib->n;
+
+    return r;
+}
+
+static int RegisterBatch(const char **names, int count, const char *argv0,
+                         nameidx_t *idx, const char *what, const char *caller,
+                         batch_adder_t adder, void *privptr,
+                         int *handles, int *errs)
+{
+  batchitem_t *items;
+  int          nitems;
+  int          i;
+  int          g_end;
+  int          n;
+  int          h;
+  int          yid;
+  int          err;
+  int          done;
+  char         subsysname[200];
+  const char  *k_name;
+
+    if (count < 0  ||  (count > 0  &&  (names == NULL  ||  handles == NULL)))
+    {
+        reporterror("%s: invalid arguments", caller);
+        errno = EINVAL;
+        return -1;
+    }
+    if (count == 0) return 0;
+
+    if ((items = malloc(count * sizeof(*items))) == NULL)
+    {
+        reporterror("%s: unable to allocate %d batch items", caller, count);
+        return -1;
+    }
+
+    /* 1. Check names, picking already registered ones right away */
+    for (n = 0, nitems = 0, done = 0;  n < count;  n++)
+    {
+        handles[n] = -1;
+        if (errs != NULL) errs[n] = 0;
+
+        if (SplitChanName(names[n], caller, what,
+                          subsysname, sizeof(subsysname), &k_name) != 0)
+        {
+            if (errs != NULL) errs[n] = errno;
+            continue;
+        }
+        if ((h = NameIdxFind(idx, names[n])) >= 0)
+        {
+            handles[n] = h;
+            done++;
+            continue;
+        }
+
+        items[nitems].name          = names[n];
+        items[nitems].k_name        = k_name;
+        items[nitems].subsysnamelen = k_name - 1 - names[n];
+        items[nitems].n             = n;
+        nitems++;
+    }
+
+    /* 2. Register the rest, subsystem by subsystem */
+    qsort(items, nitems, sizeof(*items), batchitem_compare);
+    for (i = 0;  i < nitems;  i = g_end)
+    {
+        for (g_end = i + 1;
+             g_end < nitems  &&  batchitem_prefixcmp(items + i, items + g_end) == 0;
+             g_end++);
+
+        SplitChanName(items[i].name, caller, what,
+                      subsysname, sizeof(subsysname), &k_name);
+        yid = GetSubsysID(argv0, caller, subsysname);
+        err = errno;
+
+        for (;  i < g_end;  i++)
+        {
+            n = items[i].n;
+            if (yid < 0)
+                h = -1;
+            /* Note: the same name may be present in a batch several times */
+            else if ((h = NameIdxFind(idx, items[i].name)) < 0)
+            {
+                h   = adder(yid, items[i].name, items[i].k_name,
+                            n, privptr, caller);
+                err = errno;
+            }
+
+            if (h >= 0)
+            {
+                handles[n] = h;
+                done++;
+            }
+            else if (errs != NULL)
+                errs[n] = err != 0? err : EINVAL;
+        }
+    }
+
+    free(items);
+
+    return done;
+}
+
+//// Scalar channels support /////////////////////////////////////////
+
+static int AddSimpleChan(int yid, const char *name, const char *k_name,
+                         CdrSimpleChanNewValCB_t cb, void *privptr,
+                         const char *caller)
+{
+  simplesubsys_t *syp;
+
+  Knob            k;
+  int             cid;
+  simplechan_t   *scp;
+
+    k = FindChanKnob(yid, name, k_name, caller);
+    if (k == NULL) return -1;
+
+    cid = GetSmplchSlot();
+    if (cid < 0)
+    {
+        reporterror("%s: unable to allocate chan-slot", caller);
+        errno = ENOMEM;
+        return -1;
+    }
+    scp = AccessSmplchSlot(cid);
+    /* Not a set-up channel until the end, for RlsSmplchSlot() */
+    scp->yid = yid;
+    scp->k   = NULL;
+    if ((scp->name = strdup(name)) == NULL)
+    {
+        reporterror("%s: unable to allocate chan-slot.name", caller);
+        RlsSmplchSlot(cid);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (NameIdxAdd(&smplch_idx, cid) != 0)
+    {
+        reporterror("%s: unable to index chan-slot", caller);
+        safe_free(scp->name); scp->name = NULL;
+        RlsSmplchSlot(cid);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    scp->k       = k;
+    scp->cb      = cb;
+    scp->privptr = privptr;
+
+    scp->dispatch_mode = CDR_SIMPLE_DISPATCH_INHERIT;
+    scp->have_last     = 0;
+
+    scp->min_interval   = 0;
+    scp->deadband_abs   = 0;
+    scp->deadband_rel   = 0;
+    scp->filter_pending = 0;
+    scp->have_sent      = 0;
+    scp->n_delivered    = 0;
+    scp->n_suppressed   = 0;
+
+    /* Add to the head of callback-queue */
+    syp = AccessSubsysSlot(yid);
+    scp->nxt_cid = syp->frs_cid; syp->frs_cid = cid;
+    syp->nchans++;
+    syp->refcount++;
+    syp->lazy_dirty = 1;
+
+    return cid;
+}
+
+int   CdrRegisterSimpleChan(const char *name, const char *argv0,
+                            CdrSimpleChanNewValCB_t cb, void *privptr)
+{
+  SIMPLE_LOCKED();
+  const char     *k_name;
+  char            subsysname[200];
+
+  int             yid;
+  int             cid;
+
+#if OPTION_HAS_PROGRAM_INVOCATION_NAME /* With GNU libc+ld we can determine the true argv[0] */
+    if (progname[0] == '\0') strzcpy(progname, program_invocation_short_name, sizeof(progname));
+#endif /* OPTION_HAS_PROGRAM_INVOCATION_NAME */
+
+    if (SplitChanName(name, __FUNCTION__, "channel",
+                      subsysname, sizeof(subsysname), &k_name) != 0)
+        return -1;
+
+    /* If this was already registered -- just return its id */
+    cid = NameIdxFind(&smplch_idx, name);
+    if (cid >= 0) return cid;
+
+    /* ...and reference */
+    yid = GetSubsysID(argv0, __FUNCTION__, subsysname);
+    if (yid < 0) return -1;
+
+    return AddSimpleChan(yid, name, k_name, cb, privptr, __FUNCTION__);
+}
+
+typedef struct
+{
+    CdrSimpleChanNewValCB_t   cb;
+    void                    **privptrs;
+} chan_batch_t;
+
+static int chan_batch_adder(int yid, const char *name, const char *k_name,
+                            int n, void *privptr, const char *caller)
+{
+  chan_batch_t *bp = privptr;
+
+    return AddSimpleChan(yid, name, k_name,
+                         bp->cb, bp->privptrs != NULL? bp->privptrs[n] : NULL,
+                         caller);
+}
+
+int   CdrRegisterSimpleChans(const char **names, int count, const char *argv0,
+                             CdrSimpleChanNewValCB_t cb, void **privptrs,
+                             int *handles, int *errs)
+{
+  SIMPLE_LOCKED();
+  chan_batch_t  batch;
+
+#if OPTION_HAS_PROGRAM_INVOCATION_NAME /* With GNU libc+ld we can determine the true argv[0] */
+    if (progname[0] == '\0') strzcpy(progname, program_invocation_short_name, sizeof(progname));
+#endif /* OPTION_HAS_PROGRAM_INVOCATION_NAME */
+
+    batch.cb       = cb;
+    batch.privptrs = privptrs;
+
+    return RegisterBatch(names, count, argv0,
+                         &smplch_idx, "channel", __FUNCTION__,
+                         chan_batch_adder, &batch,
+                         handles, errs);
+}
+
+int   CdrSetSimpleChanVal  (int handle, double  val)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+  simplesubsys_t *syp;
+
+  cda_localreginfo_t  localreginfo;
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    syp = AccessSubsysSlot(scp->yid);
+    FillLocalreginfo(syp, &localreginfo);
+    /* A direct write supersedes a pending async one */
+    CancelWrite(syp, handle);
+
+    return CdrSetKnobValue(scp->k, val, 0, &localreginfo);
+}
+
+int   CdrSetSimpleChanValAsync(int handle, double val)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0  ||
+        scp->dying)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+
+    QueueWrite(AccessSubsysSlot(scp->yid), handle, val);
+
+    return 0;
+}
+
+static int flush_checker(simplesubsys_t *syp, void *privptr __attribute__((unused)))
+{
+    FlushSubsysWrites(syp);
+    return 0;
+}
+
+int   CdrFlushSimpleWrites(const char *subsys, const char *argv0)
+{
+  SIMPLE_LOCKED();
+  int             yid = -1;
+
+    DispatchEnter();
+    if (subsys == NULL)
+        ForeachSubsysSlot(flush_checker, NULL);
+    else
+    {
+        yid = NameIdxFind(&subsys_idx, subsys);
+        if (yid < 0) yid = GetSubsysID(argv0, __FUNCTION__, subsys);
+        if (yid >= 0) FlushSubsysWrites(AccessSubsysSlot(yid));
+    }
+    DispatchLeave();
+
+    return subsys == NULL  ||  yid >= 0? 0 : -1;
+}
+
+int   CdrSetSimpleWriteCB(CdrSimpleWriteCB_t cb, void *privptr)
+{
+  SIMPLE_LOCKED();
+
+    write_cb         = cb;
+    write_cb_privptr = privptr;
+
+    return 0;
+}
+
+int   CdrActivateSimpleChanHistory(int handle, int size)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+  double         *new_vals  = NULL;
+  double         *new_times = NULL;
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+    if (size < 0)
+    {
+        reporterror("%s: negative size (%d)", __FUNCTION__, size);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* Allocate everything first, so that a failure leaves the old ring intact */
+    if (size > 0  &&
+        ((new_vals  = malloc(size * sizeof(*new_vals)))  == NULL  ||
+         (new_times = malloc(size * sizeof(*new_times))) == NULL))
+    {
+        safe_free(new_vals);
+        reporterror("%s: unable to allocate %d-points history", __FUNCTION__, size);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    safe_free(scp->hist_vals);
+    safe_free(scp->hist_times);
+    scp->hist_vals  = new_vals;
+    scp->hist_times = new_times;
+    scp->hist_size  = size;
+    scp->hist_first = 0;
+    scp->hist_used  = 0;
+
+    return 0;
+}
+
+int   CdrGetSimpleChanHistory(int handle, double *vals, double *timestamps, int max)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+  int             count;
+  int             start;
+  int             part;
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* The newest 'count' points, oldest first, in at most two pieces */
+    count = scp->hist_used < max? scp->hist_used : max;
+    if (count <= 0) return 0;
+    start = scp->hist_first + scp->hist_used - count;
+    if (start >= scp->hist_size) start -= scp->hist_size;
+    part  = scp->hist_size - start;
+    if (part > count) part = count;
+
+    if (vals != NULL)
+    {
+        memcpy(vals,        scp->hist_vals  + start, part           * sizeof(*vals));
+        memcpy(vals + part, scp->hist_vals,          (count - part) * sizeof(*vals));
+    }
+    if (timestamps != NULL)
+    {
+        memcpy(timestamps,        scp->hist_times + start, part           * sizeof(*timestamps));
+        memcpy(timestamps + part, scp->hist_times,         (count - part) * sizeof(*timestamps));
+    }
+
+    return count;
+}
+
+int   CdrGetSimpleChanVal  (int handle, double *val_p)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    *val_p = scp->k->curv;
+
+    return 0;
+}
+
+int   CdrGetSimpleChanVals (const int *handles, int n, double *out, int *rflags_out)
+{
+  SIMPLE_LOCKED();
+  int             i;
+  int             handle;
+  simplechan_t   *scp;
+  int             r = 0;
+
+    for (i = 0;  i < n;  i++)
+    {
+        handle = handles[i];
+        scp    = AccessSmplchSlot(handle);
+        if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+        {
+            reporterror("%s: invalid handle [%d]=%d", __FUNCTION__, i, handle);
+            out[i] = NAN;
+            if (rflags_out != NULL) rflags_out[i] = -1;
+            r = -1;
+            continue;
+        }
+
+        out[i] = scp->k->curv;
+        if (rflags_out != NULL) rflags_out[i] = scp->k->currflags;
+    }
+
+    return r;
+}
+
+typedef struct
+{
+    int  yid;
+    int  i;
+} setitem_t;
+
+static int setitem_compare(const void *a, const void *b)
+{
+  const setitem_t *ia = a;
+  const setitem_t *ib = b;
+
+    if (ia->yid != ib->yid) return ia->yid - ib->yid;
+    return ia->i - ib->i;
+}
+
+/* Returns -1 on bad handles/allocation failure (nothing written), else
+   0 with *nfailed_p set to # of writes CdrSetKnobValue() refused */
+static int SetChanVals(const int *handles, const double *vals, int n,
+                       int *nfailed_p, const char *caller)
+{
+  setitem_t      *items;
+  int             i;
+  int             handle;
+  simplechan_t   *scp;
+  simplesubsys_t *syp;
+  int             yid;
+
+  cda_localreginfo_t  localreginfo;
+
+    *nfailed_p = 0;
+    if (n <= 0) return 0;
+    if ((items = malloc(n * sizeof(*items))) == NULL)
+    {
+        reporterror("%s: unable to allocate %d items", caller, n);
+        return -1;
+    }
+
+    /* Check all handles first, so that a bad one doesn't leave a half-done write */
+    for (i = 0;  i < n;  i++)
+    {
+        handle = handles[i];
+        scp    = AccessSmplchSlot(handle);
+        if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+        {
+            reporterror("%s: invalid handle [%d]=%d", caller, i, handle);
+            free(items);
+            return -1;
+        }
+        items[i].yid = scp->yid;
+        items[i].i   = i;
+    }
+
+    /* Perform writes subsystem by subsystem */
+    qsort(items, n, sizeof(*items), setitem_compare);
+    for (i = 0, yid = -1;  i < n;  i++)
+    {
+        if (items[i].yid != yid)
+        {
+            yid = items[i].yid;
+            syp = AccessSubsysSlot(yid);
+            FillLocalreginfo(syp, &localreginfo);
+        }
+
+        scp = AccessSmplchSlot(handles[items[i].i]);
+        CancelWrite(syp, handles[items[i].i]);
+        if (CdrSetKnobValue(scp->k, vals[items[i].i], 0, &localreginfo) != 0)
+            (*nfailed_p)++;
+    }
+
+    free(items);
+
+    return 0;
+}
+
+int   CdrSetSimpleChanVals (const int *handles, const double *vals, int n)
+{
+  SIMPLE_LOCKED();
+  int             nfailed;
+
+    if (SetChanVals(handles, vals, n, &nfailed, __FUNCTION__) != 0) return -1;
+
+    return nfailed == 0? 0 : -1;
+}
+
+static int dispatch_mode_valid(int mode)
+{
+    return mode == CDR_SIMPLE_DISPATCH_INHERIT  ||
+           mode == CDR_SIMPLE_DISPATCH_ALWAYS   ||
+           mode == CDR_SIMPLE_DISPATCH_ONCHANGE;
+}
+
+int   CdrSetSimpleChanDispatch  (int handle, int mode)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+    if (!dispatch_mode_valid(mode))
+    {
+        reporterror("%s: invalid mode (%d)", __FUNCTION__, mode);
+        return -1;
+    }
+
+    scp->dispatch_mode = mode;
+    /* Switching to on-change must deliver the next value unconditionally */
+    scp->have_last     = 0;
+
+    return 0;
+}
+
+int   CdrSetSimpleSubsysDispatch(const char *subsys, const char *argv0, int mode)
+{
+  SIMPLE_LOCKED();
+  int             yid;
+  simplesubsys_t *syp;
+  int             cid;
+  simplechan_t   *scp;
+
+    if (subsys == NULL  ||  *subsys == '\0')
+    {
+        reporterror("%s: NULL/empty subsystem name", __FUNCTION__);
+        return -1;
+    }
+    /* INHERIT makes no sense for subsystem, treat it as "back to default" */
+    if (mode == CDR_SIMPLE_DISPATCH_INHERIT) mode = CDR_SIMPLE_DISPATCH_ALWAYS;
+    if (!dispatch_mode_valid(mode))
+    {
+        reporterror("%s: invalid mode (%d)", __FUNCTION__, mode);
+        return -1;
+    }
+
+    yid = GetSubsysID(argv0, __FUNCTION__, subsys);
+    if (yid < 0) return -1;
+    syp = AccessSubsysSlot(yid);
+
+    syp->dispatch_mode = mode;
+    syp->configured    = 1;
+    for (cid = syp->frs_cid;  cid >= 0;  cid = scp->nxt_cid)
+    {
+        scp = AccessSmplchSlot(cid);
+        scp->have_last = 0;
+    }
+
+    return 0;
+}
+
+int   CdrSetSimpleChanFilter(int handle, double max_rate,
+                             double deadband_abs, double deadband_rel)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+    /* Note: "!(x >= 0)" catches NaNs too */
+    if (!(max_rate >= 0)  ||  !(deadband_abs >= 0)  ||  !(deadband_rel >= 0))
+    {
+        reporterror("%s: negative/NaN max_rate/deadband (%g,%g,%g)",
+                    __FUNCTION__, max_rate, deadband_abs, deadband_rel);
+        errno = EINVAL;
+        return -1;
+    }
+
+    scp->min_interval   = max_rate > 0? 1 / max_rate : 0;
+    scp->deadband_abs   = deadband_abs;
+    scp->deadband_rel   = deadband_rel;
+    /* Next update is delivered unconditionally */
+    scp->filter_pending = 0;
+    scp->have_sent      = 0;
+
+    return 0;
+}
+
+int   CdrGetSimpleChanFilterStats(int handle,
+                                  unsigned int *delivered_p,
+                                  unsigned int *suppressed_p)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (delivered_p  != NULL) *delivered_p  = scp->n_delivered;
+    if (suppressed_p != NULL) *suppressed_p = scp->n_suppressed;
+
+    return 0;
+}
+
+int   CdrSetSimpleSubsysProcessing(const char *subsys, const char *argv0, int mode)
+{
+  SIMPLE_LOCKED();
+  int             yid;
+  simplesubsys_t *syp;
+
+    if (subsys == NULL  ||  *subsys == '\0')
+    {
+        reporterror("%s: NULL/empty subsystem name", __FUNCTION__);
+        return -1;
+    }
+    if (mode != CDR_SIMPLE_PROCESS_ALL  &&  mode != CDR_SIMPLE_PROCESS_REGISTERED)
+    {
+        reporterror("%s: invalid mode (%d)", __FUNCTION__, mode);
+        return -1;
+    }
+
+    yid = GetSubsysID(argv0, __FUNCTION__, subsys);
+    if (yid < 0) return -1;
+    syp = AccessSubsysSlot(yid);
+
+    syp->process_mode = mode;
+    syp->lazy_dirty   = 1;
+    syp->configured   = 1;
+
+    return 0;
+}
+
+int   CdrAddSimpleSubsysDependency(const char *subsys, const char *argv0,
+                                   const char *knobname)
+{
+  SIMPLE_LOCKED();
+  int             yid;
+  simplesubsys_t *syp;
+  Knob            k;
+  int             n;
+  knobref_t      *new_deps;
+  int             new_allocd;
+  char           *name;
+
+    if (subsys == NULL  ||  *subsys == '\0'  ||  knobname == NULL  ||  *knobname == '\0')
+    {
+        reporterror("%s: NULL/empty subsystem/knob name", __FUNCTION__);
+        errno = EINVAL;
+        return -1;
+    }
+
+    yid = GetSubsysID(argv0, __FUNCTION__, subsys);
+    if (yid < 0) return -1;
+    syp = AccessSubsysSlot(yid);
+
+    k = FindSubsysKnob(yid, knobname);
+    if (k == NULL)
+    {
+        reporterror("%s: knob \"%s\" not found in \"%s\"",
+                    __FUNCTION__, knobname, subsys);
+        errno = ENOENT;
+        return -1;
+    }
+
+    for (n = 0;  n < syp->deps_count;  n++)
+        if (syp->deps[n].k == k) return 0;
+
+    if (syp->deps_count >= syp->deps_allocd)
+    {
+        new_allocd = syp->deps_allocd == 0? 16 : syp->deps_allocd * 2;
+        new_deps   = realloc(syp->deps, new_allocd * sizeof(*new_deps));
+        if (new_deps == NULL)
+        {
+            reporterror("%s: unable to grow dependencies list", __FUNCTION__);
+            errno = ENOMEM;
+            return -1;
+        }
+        syp->deps        = new_deps;
+        syp->deps_allocd = new_allocd;
+    }
+    /* By name, to be resolved again after an unload */
+    if ((name = strdup(knobname)) == NULL)
+    {
+        reporterror("%s: unable to copy knob name", __FUNCTION__);
+        errno = ENOMEM;
+        return -1;
+    }
+    syp->deps[syp->deps_count].name = name;
+    syp->deps[syp->deps_count].k    = k;
+    syp->deps_count++;
+    syp->lazy_dirty = 1;
+    syp->configured = 1;
+
+    return 0;
+}
+
+int   CdrSetSimpleSubsysLocalRegs(const char *subsys, const char *argv0, int count)
+{
+  SIMPLE_LOCKED();
+  int             yid;
+  simplesubsys_t *syp;
+
+    if (subsys == NULL  ||  *subsys == '\0')
+    {
+        reporterror("%s: NULL/empty subsystem name", __FUNCTION__);
+        errno = EINVAL;
+        return -1;
+    }
+    if (count < 0)
+    {
+        reporterror("%s: negative count (%d)", __FUNCTION__, count);
+        errno = EINVAL;
+        return -1;
+    }
+
+    yid = GetSubsysID(argv0, __FUNCTION__, subsys);
+    if (yid < 0) return -1;
+    syp = AccessSubsysSlot(yid);
+
+    if (ResizeLocalregs(syp, count) != 0)
+    {
+        reporterror("%s: unable to resize local registers to %d",
+                    __FUNCTION__, count);
+        errno = ENOMEM;
+        return -1;
+    }
+    syp->localregs_set = 1;
+    syp->configured    = 1;
+
+    return 0;
+}
+
+int   CdrSetSimpleSubsysCycleCB(const char *subsys, const char *argv0,
+                                CdrSimpleCycleCB_t cb, void *privptr)
+{
+  SIMPLE_LOCKED();
+  int             yid;
+  simplesubsys_t *syp;
+
+    if (subsys == NULL  ||  *subsys == '\0')
+    {
+        reporterror("%s: NULL/empty subsystem name", __FUNCTION__);
+        return -1;
+    }
+
+    /* Threaded mode delivers updates only via the queue */
+    if (simple_threaded  &&  cb != NULL)
+    {
+        reporterror("%s: cycle callbacks aren't supported in threaded mode",
+                    __FUNCTION__);
+        errno = EBUSY;
+        return -1;
+    }
+
+    yid = GetSubsysID(argv0, __FUNCTION__, subsys);
+    if (yid < 0) return -1;
+    syp = AccessSubsysSlot(yid);
+
+    syp->cycle_cb      = cb;
+    syp->cycle_privptr = privptr;
+    syp->configured    = 1;
+
+    return 0;
+}
+
+//// Threaded mode ///////////////////////////////////////////////////
+
+static int cycle_cb_checker(simplesubsys_t *syp, void *privptr __attribute__((unused)))
+{
+    return syp->cycle_cb != NULL;
+}
+
+static void CloseWakeFd(void)
+{
+    if (simple_wake_fdh >= 0) sl_del_fd(simple_wake_fdh);
+    if (simple_wake_fd  >= 0) close(simple_wake_fd);
+    simple_wake_fdh = -1;
+    simple_wake_fd  = -1;
+}
+
+int   CdrSimpleStartThread (int queue_size)
+{
+  int  r;
+  int  yid;
+  SIMPLE_LOCKED();
+
+    if (simple_threaded)
+    {
+        reporterror("%s: event thread is already running", __FUNCTION__);
+        return -1;
+    }
+    /* Those can't be queued, so refuse rather than drop them silently */
+    yid = ForeachSubsysSlot(cycle_cb_checker, NULL);
+    if (yid >= 0)
+    {
+        reporterror("%s: subsystem \"%s\" has a cycle callback, which threaded mode doesn't support",
+                    __FUNCTION__, AccessSubsysSlot(yid)->subsysname);
+        errno = EBUSY;
+        return -1;
+    }
+    if (queue_size <= 0) queue_size = UPDQ_DEF_SIZE;
+
+    if (UpdQueueInit(queue_size) != 0)
+    {
+        reporterror("%s: unable to create %d-records queue: %s",
+                    __FUNCTION__, queue_size, cx_strerror(errno));
+        return -1;
+    }
+    if ((simple_wake_fd  = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0  ||
+        (simple_wake_fdh = sl_add_fd(0, NULL, simple_wake_fd, SL_RD,
+                                     SimpleWakeProc, NULL)) < 0)
+    {
+        reporterror("%s: unable to set up wakeup fd: %s",
+                    __FUNCTION__, cx_strerror(errno));
+        CloseWakeFd();
+        UpdQueueFini();
+        return -1;
+    }
+
+    /* Set the flag before the thread starts, so that no event is dispatched the old way */
+    simple_threaded = 1;
+    r = pthread_create(&simple_thread, NULL, SimpleThreadProc, NULL);
+    if (r != 0)
+    {
+        simple_threaded = 0;
+        CloseWakeFd();
+        UpdQueueFini();
+        reporterror("%s: pthread_create(): %s", __FUNCTION__, cx_strerror(r));
+        return -1;
+    }
+
+    return 0;
+}
+
+int   CdrSimpleStopThread  (void)
+{
+  int       id;
+  uint64_t  one = 1;
+
+    SimpleLock();
+    if (!simple_threaded)
+    {
+        SimpleUnlock();
+        return 0;
+    }
+    /* Wakes select() even without traffic; the loop breaks itself */
+    if (write(simple_wake_fd, &one, sizeof(one)) < 0) {/* Counter overflow: is readable anyway */}
+    SimpleUnlock();
+
+    pthread_join(simple_thread, NULL);
+
+    SimpleLock();
+    simple_threaded = 0;
+    CloseWakeFd();
+    UpdQueueFini();
+    /* No records are left, so released ids are free again */
+    for (id = 1;  id < smplch_list_allocd;  id++) AccessSmplchSlot(id)->quarantined = 0;
+    for (id = 1;  id < sbigch_list_allocd;  id++) AccessSbigchSlot(id)->quarantined = 0;
+    /* Reaping scheduled on the stopped loop won't happen there */
+    if (dispatch_depth == 0  &&  deferred_releases > 0) ReapDeferred();
+    SimpleUnlock();
+
+    return 0;
+}
+
+int   CdrSimpleQueueFd     (void)
+{
+    return updq_fd;
+}
+
+int   CdrSimpleDrainQueue  (CdrSimpleUpdate_t *recs, int max)
+{
+  uint64_t  counter;
+  int       n;
+
+    if (UpdQueueEnter() != 0) return -1;
+
+    /* Clear readiness first: anything pushed after this re-signals */
+    if (read(updq_fd, &counter, sizeof(counter)) < 0) {/* EAGAIN: was not signalled */}
+
+    for (n = 0;  n < max  &&  UpdQueuePop(recs + n) == 0;  n++);
+
+    /* Records left in the queue must keep the fd readable */
+    if (n == max) UpdQueueSignal();
+    UpdQueueLeave();
+
+    return n;
+}
+
+/* Records are resolved to callbacks under the lock, in batches, and
+   dispatched without it, so that callbacks don't stall the event thread.
+   The batch is a dispatch, so nothing is released meanwhile (slots stay
+   valid); channels unregistered by an earlier callback are marked dying
+   and skipped. */
+
+enum {PENDING_BATCH = 64};
+
+typedef struct
+{
+    CdrSimpleUpdate_t        u;
+    CdrSimpleChanNewValCB_t  chan_cb;
+    CdrSimpleChanNewBigCB_t  bigc_cb;
+    CdrSimpleWriteCB_t       wr_cb;
+    void                    *privptr;
+    int                     *dying_p;
+    uint64_t                *callbacks_p;  // Perf, NULL if off
+    CdrSimpleHist_t         *cb_time_p;
+    int                      called;
+    uint64_t                 cb_time;
+} pendingitem_t;
+
+/* Pops up to max records and resolves them; returns # popped */
+static int PopPendingBatch(pendingitem_t *items, int max, int *count_p)
+{
+  pendingitem_t       *ip;
+  int                  n;
+  int                  count;
+  simplechan_t        *scp;
+  splbigchan_t        *sbp;
+  CdrSimpleChanPerf_t *chperf;
+  CdrSimpleBigcPerf_t *bcperf;
+
+    for (n = 0, count = 0;  n < max;  n++)
+    {
+        ip = items + count;
+        if (UpdQueuePop(&(ip->u)) != 0) break;
+        bzero((char *)ip + sizeof(ip->u), sizeof(*ip) - sizeof(ip->u));
+
+        if      (ip->u.kind == CDR_SIMPLE_UPD_CHAN)
+        {
+            if (ip->u.handle < 0  ||  ip->u.handle >= smplch_list_allocd) continue;
+            scp = AccessSmplchSlot(ip->u.handle);
+            if (scp->in_use == 0  ||  scp->dying  ||  scp->cb == NULL) continue;
+            ip->chan_cb = scp->cb;
+            ip->privptr = scp->privptr;
+            ip->dying_p = &(scp->dying);
+            chperf = PerfOf((void **)&(scp->perf), sizeof(*chperf));
+            if (chperf != NULL)
+            {
+                /* Wall clock (as in records) may step back */
+                HistRecord(&(chperf->queue_delay),
+                           fmax(SimpleTimestamp() - ip->u.timestamp, 0) * 1e9);
+                ip->callbacks_p = &(chperf->callbacks);
+                ip->cb_time_p   = &(chperf->cb_time);
+            }
+        }
+        else if (ip->u.kind == CDR_SIMPLE_UPD_WRITE)
+        {
+            if (ip->u.handle < 0  ||  ip->u.handle >= smplch_list_allocd) continue;
+            scp = AccessSmplchSlot(ip->u.handle);
+            if (scp->in_use == 0  ||  scp->dying  ||  write_cb == NULL) continue;
+            ip->wr_cb   = write_cb;
+            ip->privptr = write_cb_privptr;
+            ip->dying_p = &(scp->dying);
+        }
+        else if (ip->u.kind == CDR_SIMPLE_UPD_BIGC)
+        {
+            if (ip->u.handle < 0  ||  ip->u.handle >= sbigch_list_allocd) continue;
+            sbp = AccessSbigchSlot(ip->u.handle);
+            if (sbp->in_use == 0  ||  sbp->dying  ||  sbp->cb == NULL) continue;
+            ip->bigc_cb = sbp->cb;
+            ip->privptr = sbp->privptr;
+            ip->dying_p = &(sbp->dying);
+            bcperf = PerfOf((void **)&(sbp->perf), sizeof(*bcperf));
+            if (bcperf != NULL)
+            {
+                ip->callbacks_p = &(bcperf->callbacks);
+                ip->cb_time_p   = &(bcperf->cb_time);
+            }
+        }
+        else continue;
+
+        count++;
+    }
+
+    *count_p = count;
+
+    return n;
+}
+
+static void CallPendingItem(pendingitem_t *ip)
+{
+  uint64_t  t0 = 0;
+
+    if (__atomic_load_n(ip->dying_p, __ATOMIC_RELAXED)) return;
+
+    if (ip->cb_time_p != NULL) t0 = PerfNow();
+    if      (ip->chan_cb != NULL) ip->chan_cb(ip->u.handle, ip->u.val, ip->privptr);
+    else if (ip->bigc_cb != NULL) ip->bigc_cb(ip->u.handle, ip->privptr);
+    else                          ip->wr_cb  (ip->u.handle, ip->u.val, ip->u.rflags, ip->privptr);
+    if (ip->cb_time_p != NULL) ip->cb_time = PerfNow() - t0;
+    ip->called = 1;
+}
+
+int   CdrSimpleProcessPending(int max_events)
+{
+  pendingitem_t      items[PENDING_BATCH];
+  uint64_t           counter;
+  int                n;
+  int                total;
+  int                want;
+  int                count;
+  int                i;
+
+    SimpleLock();
+    if (updq_fd < 0)
+    {
+        SimpleUnlock();
+        reporterror("%s: event thread is not running", __FUNCTION__);
+        errno = EINVAL;
+        return -1;
+    }
+
+    if (read(updq_fd, &counter, sizeof(counter)) < 0) {/* EAGAIN: was not signalled */}
+
+    total = 0;
+    do
+    {
+        want = max_events <= 0  ||  max_events - total > PENDING_BATCH?
+               PENDING_BATCH : max_events - total;
+
+        DispatchEnter();
+        n = PopPendingBatch(items, want, &count);
+        SimpleUnlock();
+
+        for (i = 0;  i < count;  i++) CallPendingItem(items + i);
+
+        SimpleLock();
+        for (i = 0;  i < count;  i++)
+            if (items[i].called  &&  items[i].cb_time_p != NULL)
+            {
+                (*(items[i].callbacks_p))++;
+                HistRecord(items[i].cb_time_p, items[i].cb_time);
+            }
+        DispatchLeave();
+
+        total += n;
+    }
+    /* Note: a callback may have stopped the thread meanwhile */
+    while (n == want  &&  updq_fd >= 0  &&
+           (max_events <= 0  ||  total < max_events));
+
+    if (max_events > 0  &&  total == max_events  &&  updq_fd >= 0) UpdQueueSignal();
+    SimpleUnlock();
+
+    return total;
+}
+
+int   CdrSimpleGetQueueStats(unsigned int *pushed_p, unsigned int *dropped_p)
+{
+    if (pushed_p  != NULL) *pushed_p  = __atomic_load_n(&updq_pushed,  __ATOMIC_RELAXED);
+    if (dropped_p != NULL) *dropped_p = __atomic_load_n(&updq_dropped, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+//// Big-channels support ////////////////////////////////////////////
+
+/* Stores the just-arrived frame into the ring, without any allocation.
+   When full, the new frame goes into the oldest one's slot, which is
+   forgotten only after the fetch succeeds; either way an event costs
+   at most one drop */
+static void RingPushFrame(splbigchan_t *sbp)
+{
+  int           full = sbp->ring_used == sbp->ring_size;
+  int           slot;
+  bigcframe_t  *fp;
+  int           r;
+  tag_t         tag;
+  rflags_t      rflags;
+
+    if (full  &&  sbp->ring_policy == CDR_SIMPLE_RING_DROP_NEWEST)
+    {
+        sbp->ring_dropped++;
+        return;
+    }
+
+    slot = (sbp->ring_first + sbp->ring_used) % sbp->ring_size;
+    fp   = sbp->ring_frames + slot;
+    r = cda_getbigcdata(sbp->bigc_handle, 0, sbp->max_datasize,
+                        sbp->ring_buf + slot * sbp->max_datasize);
+    if (r < 0  ||
+        cda_getbigcstats(sbp->bigc_handle, &tag, &rflags) < 0)
+    {
+        sbp->ring_dropped++;
+        return;
+    }
+    fp->size   = r;
+    fp->tag    = tag;
+    fp->rflags = rflags;
+
+    /* Overwrite-oldest: the first frame is gone now */
+    if (full)
+    {
+        sbp->ring_first = (sbp->ring_first + 1) % sbp->ring_size;
+        sbp->ring_dropped++;
+    }
+    else
+        sbp->ring_used++;
+    sbp->ring_pushed++;
+}
+
+static void ReduceFrame(splbigchan_t *sbp);
+
+static void BigcEvent(int bid)
+{
+  splbigchan_t   *sbp = AccessSbigchSlot(bid);
+
+  tag_t           tag;
+  rflags_t        rflags;
+  CdrSimpleBigcPerf_t *bcperf;
+  uint64_t        t0 = 0;
+
+    if (sbp->dying) return;
+
+    bcperf = PerfOf((void **)&(sbp->perf), sizeof(*bcperf));
+    if (bcperf != NULL) bcperf->events++;
+
+    sbp->generation++;
+    if (sbp->ring_size > 0) RingPushFrame(sbp);
+    if (sbp->reduce_flags != 0) ReduceFrame(sbp);
+
+    if (simple_threaded)
+    {
+        if (cda_getbigcstats(sbp->bigc_handle, &tag, &rflags) < 0) rflags = 0;
+        QueueUpdate(CDR_SIMPLE_UPD_BIGC, bid, sbp->generation, rflags,
+                    SimpleTimestamp());
+        UpdQueueSignal();
+        return;
+    }
+
+    if (sbp->cb != 0)
+    {
+        if (bcperf != NULL) t0 = PerfNow();
+        sbp->cb(bid, sbp->privptr);
+        if (bcperf != NULL)
+        {
+            bcperf->callbacks++;
+            HistRecord(&(bcperf->cb_time), PerfNow() - t0);
+        }
+    }
+}
+
+static void bigc_event_proc(cda_serverid_t  sid       __attribute__((unused)),
+                            int             reason    __attribute__((unused)),
+                            void           *privptr)
+{
+  int             sv_id = ptr2lint(privptr);
+  bigcsrv_t      *svp   = AccessBigcsrvSlot(sv_id);
+
+    in_cda_callback++;
+    DispatchEnter();
+
+    /* The connection's only bigc */
+    if (svp->frs_bid >= 0) BigcEvent(svp->frs_bid);
+
+    DispatchLeave();
+    in_cda_callback--;
+}
+
+/* Establishes a connection to srvref */
+static int NewBigcsrvID(const char *srvref, const char *caller)
+{
+  int        sv_id;
+  bigcsrv_t *svp;
+
+    sv_id = GetBigcsrvSlot();
+    if (sv_id < 0)
+    {
+        reporterror("%s: unable to allocate bigcsrv-slot", caller);
+        errno = ENOMEM;
+        return -1;
+    }
+    svp = AccessBigcsrvSlot(sv_id);
+    svp->refcount = 0;
+    svp->frs_bid  = -1;
+
+    svp->sid = cda_new_server(srvref,
+                              bigc_event_proc, lint2ptr(sv_id),
+                              CDA_BIGC);
+    if (svp->sid == CDA_SERVERID_ERROR)
+    {
+        reporterror("%s: cda_new_server(server=%s): %s",
+                   caller, srvref, cx_strerror(errno));
+        RlsBigcsrvSlot(sv_id);
+        return -1;
+    }
+
+    return sv_id;
+}
+
+static int AddSimpleBigc(int yid, const char *name, const char *k_name,
+                         size_t max_datasize,
+                         CdrSimpleChanNewBigCB_t cb, void *privptr,
+                         const char *caller)
+{
+  simplesubsys_t *syp;
+
+  Knob            k;
+  int             bid;
+  splbigchan_t   *sbp;
+  bigcsrv_t      *svp;
+
+  int             bigc_n;
+  const char     *ph_srvref;
+  int             ph_chan_n;
+  cda_serverid_t  ph_defsid;
+
+    k = FindChanKnob(yid, name, k_name, caller);
+    if (k == NULL) return -1;
+
+    bid = GetSbigchSlot();
+    if (bid < 0)
+    {
+        reporterror("%s: unable to allocate bigc-slot", caller);
+        errno = ENOMEM;
+        return -1;
+    }
+    sbp = AccessSbigchSlot(bid);
+    if ((sbp->name = strdup(name)) == NULL)
+    {
+        reporterror("%s: unable to allocate bigc-slot.name", caller);
+        RlsSbigchSlot(bid);
+        errno = ENOMEM;
+        return -1;
+    }
+    if (NameIdxAdd(&sbigch_idx, bid) != 0)
+    {
+        reporterror("%s: unable to index bigc-slot", caller);
+        safe_free(sbp->name); sbp->name = NULL;
+        RlsSbigchSlot(bid);
+        errno = ENOMEM;
+        return -1;
+    }
+
+    sbp->yid     = yid;
+    sbp->k       = k;
+    sbp->cb      = cb;
+    sbp->privptr = privptr;
+
+    sbp->max_datasize = max_datasize;
+    sbp->generation   = 0;
+    sbp->databuf_gen  = -1;
+    sbp->decode_units = 4;
+    sbp->decode_r     = 1.0;
+    sbp->decode_d     = 0.0;
+
+    /* Obtain address data... */
+    bigc_n = k->color;
+    if (k->kind == LOGK_DIRECT  &&
+        cda_srcof_physchan(k->physhandle, &ph_srvref, &ph_chan_n) == 1)
+    {
+        ph_defsid = cda_sidof_physchan(k->physhandle);
+    }
+    else
+    {
+        ph_srvref = NULL;
+        ph_chan_n = -1;
+        ph_defsid = CDA_SERVERID_ERROR;
+    }
+    /* ...and try to bind */
+    sbp->srv_id = NewBigcsrvID(ph_srvref, caller);
+    if (sbp->srv_id < 0) goto CLEANUP;
+    svp = AccessBigcsrvSlot(sbp->srv_id);
+    sbp->bigc_sid = svp->sid;
+    sbp->bigc_handle = cda_add_bigc(sbp->bigc_sid, bigc_n,
+                                    CX_MAX_BIGC_PARAMS, max_datasize,
+                                    CX_CACHECTL_SHARABLE, 
+                                    CX_BIGC_IMMED_YES);
+    if (sbp->bigc_handle < 0)
+    {
+        reporterror("%s: cda_add_bigc(%s): %s",
+                    caller, name, cx_strerror(errno));
+        RlsBigcsrvSlot(sbp->srv_id);
+        goto CLEANUP;
+    }
+    cda_run_server(sbp->bigc_sid);
+
+    svp->refcount++;
+    sbp->nxt_srv_bid = svp->frs_bid; svp->frs_bid = bid;
+
+    /* Add to the head of callback-queue */
+    syp = AccessSubsysSlot(yid);
+    sbp->nxt_bid = syp->frs_bid; syp->frs_bid = bid;
+    syp->refcount++;
+
+    return bid;
+
+ CLEANUP:
+    RlsSbigchSlot(bid);
+    return -1;
+}
+
+int   CdrRegisterSimpleBigc(const char *name, const char *argv0,
+                            size_t max_datasize,
+                            CdrSimpleChanNewBigCB_t cb, void *privptr)
+{
+  SIMPLE_LOCKED();
+  const char     *k_name;
+  char            subsysname[200];
+
+  int             yid;
+  int             bid;
+
+#if OPTION_HAS_PROGRAM_INVOCATION_NAME /* With GNU libc+ld we can determine the true argv[0] */
+    if (progname[0] == '\0') strzcpy(progname, program_invocation_short_name, sizeof(progname));
+#endif /* OPTION_HAS_PROGRAM_INVOCATION_NAME */
+
+    if (SplitChanName(name, __FUNCTION__, "bigchan",
+                      subsysname, sizeof(subsysname), &k_name) != 0)
+        return -1;
+
+    /* If this was already registered -- just return its id */
+    bid = NameIdxFind(&sbigch_idx, name);
+    if (bid >= 0) return bid;
+
+    /* ...and reference */
+    yid = GetSubsysID(argv0, __FUNCTION__, subsysname);
+    if (yid < 0) return -1;
+
+    return AddSimpleBigc(yid, name, k_name, max_datasize, cb, privptr,
+                         __FUNCTION__);
+}
+
+typedef struct
+{
+    size_t                    max_datasize;
+    CdrSimpleChanNewBigCB_t   cb;
+    void                    **privptrs;
+} bigc_batch_t;
+
+static int bigc_batch_adder(int yid, const char *name, const char *k_name,
+                            int n, void *privptr, const char *caller)
+{
+  bigc_batch_t *bp = privptr;
+
+    return AddSimpleBigc(yid, name, k_name, bp->max_datasize,
+                         bp->cb, bp->privptrs != NULL? bp->privptrs[n] : NULL,
+                         caller);
+}
+
+int   CdrRegisterSimpleBigcs(const char **names, int count, const char *argv0,
+                             size_t max_datasize,
+                             CdrSimpleChanNewBigCB_t cb, void **privptrs,
+                             int *handles, int *errs)
+{
+  SIMPLE_LOCKED();
+  bigc_batch_t  batch;
+
+#if OPTION_HAS_PROGRAM_INVOCATION_NAME /* With GNU libc+ld we can determine the true argv[0] */
+    if (progname[0] == '\0') strzcpy(progname, program_invocation_short_name, sizeof(progname));
+#endif /* OPTION_HAS_PROGRAM_INVOCATION_NAME */
+
+    batch.max_datasize = max_datasize;
+    batch.cb           = cb;
+    batch.privptrs     = privptrs;
+
+    return RegisterBatch(names, count, argv0,
+                         &sbigch_idx, "bigchan", __FUNCTION__,
+                         bigc_batch_adder, &batch,
+                         handles, errs);
+}
+
+int   CdrGetSimpleBigcData (int handle, int byte_ofs, int byte_size, void *buf)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+  CdrSimpleBigcPerf_t *bcperf;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    r = cda_getbigcdata(sbp->bigc_handle, byte_ofs, byte_size, buf);
+    if (r > 0  &&  (bcperf = PerfOf((void **)&(sbp->perf), sizeof(*bcperf))) != NULL)
+        bcperf->bytes_read += r;
+
+    return r;
+}
+
+/* Makes databuf hold current data; the copy is done at most once per event.
+   count!=0 (public views) accounts the served data in bytes_read, while
+   internal users (decoding, reduction) aren't client reads */
+static int RefreshBigcDatabuf(splbigchan_t *sbp, int count)
+{
+  int  r;
+  CdrSimpleBigcPerf_t *bcperf;
+
+    if (sbp->databuf_gen != sbp->generation  ||  sbp->databuf == NULL)
+    {
+        if (sbp->databuf == NULL  &&
+            (sbp->databuf = malloc(sbp->max_datasize != 0? sbp->max_datasize : 1)) == NULL)
+            return -1;
+
+        r = cda_getbigcdata(sbp->bigc_handle, 0, sbp->max_datasize, sbp->databuf);
+        if (r < 0) return -1;
+
+        sbp->datasize    = r;
+        sbp->databuf_gen = sbp->generation;
+    }
+
+    if (count  &&  (bcperf = PerfOf((void **)&(sbp->perf), sizeof(*bcperf))) != NULL)
+        bcperf->bytes_read += sbp->datasize;
+
+    return 0;
+}
+
+int   CdrAcquireSimpleBigcView(int handle, const void **data_p, size_t *size_p, int *gen_p)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    /* A held view stays intact until released */
+    if (sbp->view_holds == 0  &&  RefreshBigcDatabuf(sbp, 1) != 0)
+    {
+        reporterror("%s: unable to obtain bigc data (%d): %s",
+                    __FUNCTION__, handle, cx_strerror(errno));
+        return -1;
+    }
+    sbp->view_holds++;
+
+    *data_p = sbp->databuf;
+    *size_p = sbp->datasize;
+    if (gen_p != NULL) *gen_p = sbp->databuf_gen;
+
+    return 0;
+}
+
+int   CdrReleaseSimpleBigcView(int handle)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    if (sbp->view_holds == 0)
+    {
+        reporterror("%s: no acquired view of bigc %d", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+    sbp->view_holds--;
+
+    return 0;
+}
+
+int   CdrSetSimpleBigcRing (int handle, int nframes, int policy)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  uint8          *new_buf    = NULL;
+  bigcframe_t    *new_frames = NULL;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+    if (nframes < 0  ||
+        (policy != CDR_SIMPLE_RING_OVERWRITE_OLDEST  &&
+         policy != CDR_SIMPLE_RING_DROP_NEWEST))
+    {
+        reporterror("%s: invalid nframes=%d/policy=%d",
+                    __FUNCTION__, nframes, policy);
+        return -1;
+    }
+
+    if (nframes > 0)
+    {
+        new_buf    = malloc(nframes * (sbp->max_datasize != 0? sbp->max_datasize : 1));
+        new_frames = malloc(nframes * sizeof(*new_frames));
+        if (new_buf == NULL  ||  new_frames == NULL)
+        {
+            reporterror("%s: unable to allocate %d frames of %zu bytes",
+                        __FUNCTION__, nframes, sbp->max_datasize);
+            safe_free(new_buf);
+            safe_free(new_frames);
+            return -1;
+        }
+    }
+
+    /* Note: frames queued so far are discarded */
+    safe_free(sbp->ring_buf);
+    safe_free(sbp->ring_frames);
+    sbp->ring_buf     = new_buf;
+    sbp->ring_frames  = new_frames;
+    sbp->ring_size    = nframes;
+    sbp->ring_policy  = policy;
+    sbp->ring_first   = 0;
+    sbp->ring_used    = 0;
+    sbp->ring_pushed  = 0;
+    sbp->ring_dropped = 0;
+
+    return 0;
+}
+
+int   CdrPopSimpleBigcFrame(int handle, void *buf, size_t bufsize,
+                            size_t *size_p, int *tag_p, int *rflags_p)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  bigcframe_t    *fp;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+    if (sbp->ring_used == 0) return 0;
+
+    fp = sbp->ring_frames + sbp->ring_first;
+    memcpy(buf, sbp->ring_buf + sbp->ring_first * sbp->max_datasize,
+           fp->size < bufsize? fp->size : bufsize);
+    if (size_p   != NULL) *size_p   = fp->size;
+    if (tag_p    != NULL) *tag_p    = fp->tag;
+    if (rflags_p != NULL) *rflags_p = fp->rflags;
+
+    sbp->ring_first = (sbp->ring_first + 1) % sbp->ring_size;
+    sbp->ring_used--;
+
+    return 1;
+}
+
+int   CdrGetSimpleBigcRingStats(int handle, int *used_p,
+                                unsigned int *pushed_p, unsigned int *dropped_p)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    if (used_p    != NULL) *used_p    = sbp->ring_used;
+    if (pushed_p  != NULL) *pushed_p  = sbp->ring_pushed;
+    if (dropped_p != NULL) *dropped_p = sbp->ring_dropped;
+
+    return 0;
+}
+
+int   CdrSetSimpleBigcData (int handle, int byte_ofs, int byte_size, void *buf, int dataunits)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    r = cda_setbigcdata(sbp->bigc_handle, byte_ofs, byte_size, buf, dataunits);
+
+    return r;
+}
+
+
+int   CdrGetSimpleBigcStats(int handle, int *age_p, int *rflags_p)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+  tag_t           tag;    // Note: these two are of cx-specific types,
+  rflags_t        rflags; //       while parameters are just 'int' ("simple"!)
+  CdrSimpleBigcPerf_t *bcperf;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    r = cda_getbigcstats(sbp->bigc_handle, &tag, &rflags);
+    if (r > 0)
+    {
+        if (age_p    != NULL) *age_p    = tag;
+        if (rflags_p != NULL) *rflags_p = rflags;
+        if ((bcperf = PerfOf((void **)&(sbp->perf), sizeof(*bcperf))) != NULL)
+            HistRecord(&(bcperf->age), tag);
+    }
+
+    return r;
+}
+
+
+int   CdrGetSimpleBigcParam(int handle, int n, int *val_p)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+  int32           v;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    r = cda_getbigcparams(sbp->bigc_handle, n, 1, &v);
+    if (r > 0) *val_p = v;
+
+    return r;
+}
+
+
+int   CdrSetSimpleBigcParam(int handle, int n, int  val)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+  int32           v;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+
+    v = val;
+    r = cda_setbigcparams(sbp->bigc_handle, n, 1, &v);
+
+    return r;
+}
+
+static int bigc_params_range_ok(int start, int count)
+{
+    return start >= 0  &&  count >= 0  &&  count <= CX_MAX_BIGC_PARAMS - start;
+}
+
+int   CdrGetSimpleBigcParams(int handle, int start, int count, int *vals)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+  int32           v[CX_MAX_BIGC_PARAMS];
+  int             i;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+    if (!bigc_params_range_ok(start, count))
+    {
+        reporterror("%s: invalid range start=%d count=%d",
+                    __FUNCTION__, start, count);
+        return -1;
+    }
+
+    r = cda_getbigcparams(sbp->bigc_handle, start, count, v);
+    if (r > 0)
+        for (i = 0;  i < count;  i++) vals[i] = v[i];
+
+    return r;
+}
+
+int   CdrSetSimpleBigcParams(int handle, int start, int count, const int *vals)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             r;
+  int32           v[CX_MAX_BIGC_PARAMS];
+  int             i;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        return -1;
+    }
+    if (!bigc_params_range_ok(start, count))
+    {
+        reporterror("%s: invalid range start=%d count=%d",
+                    __FUNCTION__, start, count);
+        return -1;
+    }
+
+    for (i = 0;  i < count;  i++) v[i] = vals[i];
+    r = cda_setbigcparams(sbp->bigc_handle, start, count, v);
+
+    return r;
+}
+
+//// Bigc decoding ///////////////////////////////////////////////////
+
+/* Kernels convert count int8/16/32 samples (units=1/2/4) into
+   raw*scale+offset.  The best one for the CPU is picked once, on first
+   use: x86 kernels are built with target attributes (so no -m flags are
+   needed, and a CPU lacking AVX2/SSE4.1 just never calls them), NEON is
+   baseline wherever the compiler defines __ARM_NEON.  Vector loops leave
+   tails (<1 vector) to the portable kernel.
+   CDR_SIMPLE_DECODE=portable|sse4.1|avx2|neon in the environment
+   restricts the choice (for benchmarks and cross-checks). */
+
+typedef void (*decode_f32_t)(const void *src, int units, int count,
+                             float  *dst, float  scale, float  offset);
+typedef void (*decode_f64_t)(const void *src, int units, int count,
+                             double *dst, double scale, double offset);
+
+static void DecodeF32Portable(const void *src, int units, int count,
+                              float  *dst, float  scale, float  offset)
+{
+  const int8_t   *s8  = src;
+  const int16_t  *s16 = src;
+  const int32_t  *s32 = src;
+  int             i;
+
+    if      (units == 1) for (i = 0;  i < count;  i++) dst[i] = (float)s8 [i] * scale + offset;
+    else if (units == 2) for (i = 0;  i < count;  i++) dst[i] = (float)s16[i] * scale + offset;
+    else                 for (i = 0;  i < count;  i++) dst[i] = (float)s32[i] * scale + offset;
+}
+
+static void DecodeF64Portable(const void *src, int units, int count,
+                              double *dst, double scale, double offset)
+{
+  const int8_t   *s8  = src;
+  const int16_t  *s16 = src;
+  const int32_t  *s32 = src;
+  int             i;
+
+    if      (units == 1) for (i = 0;  i < count;  i++) dst[i] = (double)s8 [i] * scale + offset;
+    else if (units == 2) for (i = 0;  i < count;  i++) dst[i] = (double)s16[i] * scale + offset;
+    else                 for (i = 0;  i < count;  i++) dst[i] = (double)s32[i] * scale + offset;
+}
+
+/* Reduction kernels accumulate min/max/sum/sum-of-squares of doubles;
+   vector ones keep per-lane accumulators, merged at the end */
+
+typedef struct
+{
+    double  min;
+    double  max;
+    double  sum;
+    double  sumsq;
+} reduceacc_t;
+
+typedef void (*reduce_f64_t)(const double *v, int count, reduceacc_t *acc);
+
+static void ReduceF64Portable(const double *v, int count, reduceacc_t *acc)
+{
+  int  i;
+
+    for (i = 0;  i < count;  i++)
+    {
+        if (v[i] < acc->min) acc->min = v[i];
+        if (v[i] > acc->max) acc->max = v[i];
+        acc->sum   += v[i];
+        acc->sumsq += v[i] * v[i];
+    }
+}
+
+static void ReduceMergeLanes(reduceacc_t *acc, int lanes, const double *mins,
+                             const double *maxs, const double *sums, const double *sqs)
+{
+  int  l;
+
+    for (l = 0;  l < lanes;  l++)
+    {
+        if (mins[l] < acc->min) acc->min = mins[l];
+        if (maxs[l] > acc->max) acc->max = maxs[l];
+        acc->sum   += sums[l];
+        acc->sumsq += sqs [l];
+    }
+}
+
+#if defined(__x86_64__)  ||  defined(__i386__)
+
+/* Narrow unaligned loads, without breaking strict aliasing */
+static inline __attribute__((target("sse4.1"))) __m128i DecodeLoad16(const void *p)
+{
+  int16_t  v;
+
+    memcpy(&v, p, sizeof(v));
+    return _mm_cvtsi32_si128((uint16_t)v);
+}
+
+static inline __attribute__((target("sse4.1"))) __m128i DecodeLoad32(const void *p)
+{
+  int32_t  v;
+
+    memcpy(&v, p, sizeof(v));
+    return _mm_cvtsi32_si128(v);
+}
+
+__attribute__((target("sse4.1")))
+static void DecodeF32Sse41(const void *src, int units, int count,
+                           float  *dst, float  scale, float  offset)
+{
+  const int8_t   *s8  = src;
+  const int16_t  *s16 = src;
+  const int32_t  *s32 = src;
+  __m128          vs  = _mm_set1_ps(scale);
+  __m128          vo  = _mm_set1_ps(offset);
+  __m128i         raw;
+  int             i;
+
+    for (i = 0;  i + 4 <= count;  i += 4)
+    {
+        if      (units == 1) raw = _mm_cvtepi8_epi32 (DecodeLoad32(s8 + i));
+        else if (units == 2) raw = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(s16 + i)));
+        else                 raw = _mm_loadu_si128   ((const __m128i *)(s32 + i));
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(raw), vs), vo));
+    }
+    DecodeF32Portable(s8 + i * units, units, count - i, dst + i, scale, offset);
+}
+
+__attribute__((target("sse4.1")))
+static void DecodeF64Sse41(const void *src, int units, int count,
+                           double *dst, double scale, double offset)
+{
+  const int8_t   *s8  = src;
+  const int16_t  *s16 = src;
+  const int32_t  *s32 = src;
+  __m128d         vs  = _mm_set1_pd(scale);
+  __m128d         vo  = _mm_set1_pd(offset);
+  __m128i         raw;
+  int             i;
+
+    for (i = 0;  i + 2 <= count;  i += 2)
+    {
+        if      (units == 1) raw = _mm_cvtepi8_epi32 (DecodeLoad16(s8  + i));
+        else if (units == 2) raw = _mm_cvtepi16_epi32(DecodeLoad32(s16 + i));
+        else                 raw = _mm_loadl_epi64   ((const __m128i *)(s32 + i));
+        _mm_storeu_pd(dst + i, _mm_add_pd(_mm_mul_pd(_mm_cvtepi32_pd(raw), vs), vo));
+    }
+    DecodeF64Portable(s8 + i * units, units, count - i, dst + i, scale, offset);
+}
+
+__attribute__((target("sse4.1")))
+static void ReduceF64Sse41(const double *v, int count, reduceacc_t *acc)
+{
+  __m128d  vmin = _mm_set1_pd(acc->min);
+  __m128d  vmax = _mm_set1_pd(acc->max);
+  __m128d  vsum = _mm_setzero_pd();
+  __m128d  vsq  = _mm_setzero_pd();
+  __m128d  x;
+  double   l[4][2];
+  int      i;
+
+    for (i = 0;  i + 2 <= count;  i += 2)
+    {
+        x    = _mm_loadu_pd(v + i);
+        vmin = _mm_min_pd(vmin, x);
+        vmax = _mm_max_pd(vmax, x);
+        vsum = _mm_add_pd(vsum, x);
+        vsq  = _mm_add_pd(vsq,  _mm_mul_pd(x, x));
+    }
+    _mm_storeu_pd(l[0], vmin);
+    _mm_storeu_pd(l[1], vmax);
+    _mm_storeu_pd(l[2], vsum);
+    _mm_storeu_pd(l[3], vsq);
+    ReduceMergeLanes(acc, 2, l[0], l[1], l[2], l[3]);
+    ReduceF64Portable(v + i, count - i, acc);
+}
+
+__attribute__((target("avx2")))
+static void DecodeF32Avx2(const void *src, int units, int count,
+                          float  *dst, float  scale, float  offset)
+{
+  const int8_t   *s8  = src;
+  const int16_t  *s16 = src;
+  const int32_t  *s32 = src;
+  __m256          vs  = _mm256_set1_ps(scale);
+  __m256          vo  = _mm256_set1_ps(offset);
+  __m256i         raw;
+  int             i;
+
+    for (i = 0;  i + 8 <= count;  i += 8)
+    {
+        if      (units == 1) raw = _mm256_cvtepi8_epi32 (_mm_loadl_epi64((const __m128i *)(s8  + i)));
+        else if (units == 2) raw = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(s16 + i)));
+        else                 raw = _mm256_loadu_si256   ((const __m256i *)(s32 + i));
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(raw), vs), vo));
+    }
+    DecodeF32Portable(s8 + i * units, units, count - i, dst + i, scale, offset);
+}
+
+__attribute__((target("avx2")))
+static void DecodeF64Avx2(const void *src, int units, int count,
+                          double *dst, double scale, double offset)
+{
+  const int8_t   *s8  = src;
+  const int16_t  *s16 = src;
+  const int32_t  *s32 = src;
+  __m256d         vs  = _mm256_set1_pd(scale);
+  __m256d         vo  = _mm256_set1_pd(offset);
+  __m128i         raw;
+  int             i;
+
+    for (i = 0;  i + 4 <= count;  i += 4)
+    {
+        if      (units == 1) raw = _mm_cvtepi8_epi32 (DecodeLoad32(s8 + i));
+        else if (units == 2) raw = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(s16 + i)));
+        else                 raw = _mm_loadu_si128   ((const __m128i *)(s32 + i));
+        _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_mul_pd(_mm256_cvtepi32_pd(raw), vs), vo));
+    }
+    DecodeF64Portable(s8 + i * units, units, count - i, dst + i, scale, offset);
+}
+
+__attribute__((target("avx2")))
+static void ReduceF64Avx2(const double *v, int count, reduceacc_t *acc)
+{
+  __m256d  vmin = _mm256_set1_pd(acc->min);
+  __m256d  vmax = _mm256_set1_pd(acc->max);
+  __m256d  vsum = _mm256_setzero_pd();
+  __m256d  vsq  = _mm256_setzero_pd();
+  __m256d  x;
+  double   l[4][4];
+  int      i;
+
+    for (i = 0;  i + 4 <= count;  i += 4)
+    {
+        x    = _mm256_loadu_pd(v + i);
+        vmin = _mm256_min_pd(vmin, x);
+        vmax = _mm256_max_pd(vmax, x);
+        vsum = _mm256_add_pd(vsum, x);
+        vsq  = _mm256_add_pd(vsq,  _mm256_mul_pd(x, x));
+    }
+    _mm256_storeu_pd(l[0], vmin);
+    _mm256_storeu_pd(l[1], vmax);
+    _mm256_storeu_pd(l[2], vsum);
+    _mm256_storeu_pd(l[3], vsq);
+    ReduceMergeLanes(acc, 4, l[0], l[1], l[2], l[3]);
+    ReduceF64Portable(v + i, count - i, acc);
+}
+
+#endif /* x86 */
+
+#ifdef __ARM_NEON
+
+/* 8 samples as two int32x4 halves */
+static inline void DecodeLoadNeon(const void *src, int units, int i,
+                                  int32x4_t *lo_p, int32x4_t *hi_p)
+{
+  int16x8_t  h;
+
+    if (units == 4)
+    {
+        *lo_p = vld1q_s32((const int32_t *)src + i);
+        *hi_p = vld1q_s32((const int32_t *)src + i + 4);
+        return;
+    }
+    if (units == 1) h = vmovl_s8(vld1_s8((const int8_t *)src + i));
+    else            h = vld1q_s16((const int16_t *)src + i);
+    *lo_p = vmovl_s16(vget_low_s16 (h));
+    *hi_p = vmovl_s16(vget_high_s16(h));
+}
+
+static void DecodeF32Neon(const void *src, int units, int count,
+                          float  *dst, float  scale, float  offset)
+{
+  float32x4_t  vs = vdupq_n_f32(scale);
+  float32x4_t  vo = vdupq_n_f32(offset);
+  int32x4_t    lo;
+  int32x4_t    hi;
+  int          i;
+
+    for (i = 0;  i + 8 <= count;  i += 8)
+    {
+        DecodeLoadNeon(src, units, i, &lo, &hi);
+        vst1q_f32(dst + i,     vaddq_f32(vmulq_f32(vcvtq_f32_s32(lo), vs), vo));
+        vst1q_f32(dst + i + 4, vaddq_f32(vmulq_f32(vcvtq_f32_s32(hi), vs), vo));
+    }
+    DecodeF32Portable((const int8_t *)src + i * units, units, count - i, dst + i, scale, offset);
+}
+
+#ifdef __aarch64__  /* 32-bit NEON has no doubles */
+static inline float64x2_t DecodeF64Pair(int32x2_t raw, float64x2_t vs, float64x2_t vo)
+{
+    return vaddq_f64(vmulq_f64(vcvtq_f64_s64(vmovl_s32(raw)), vs), vo);
+}
+
+static void DecodeF64Neon(const void *src, int units, int count,
+                          double *dst, double scale, double offset)
+{
+  float64x2_t  vs = vdupq_n_f64(scale);
+  float64x2_t  vo = vdupq_n_f64(offset);
+  int32x4_t    lo;
+  int32x4_t    hi;
+  int          i;
+
+    for (i = 0;  i + 8 <= count;  i += 8)
+    {
+        DecodeLoadNeon(src, units, i, &lo, &hi);
+        vst1q_f64(dst + i,     DecodeF64Pair(vget_low_s32 (lo), vs, vo));
+        vst1q_f64(dst + i + 2, DecodeF64Pair(vget_high_s32(lo), vs, vo));
+        vst1q_f64(dst + i + 4, DecodeF64Pair(vget_low_s32 (hi), vs, vo));
+        vst1q_f64(dst + i + 6, DecodeF64Pair(vget_high_s32(hi), vs, vo));
+    }
+    DecodeF64Portable((const int8_t *)src + i * units, units, count - i, dst + i, scale, offset);
+}
+
+static void ReduceF64Neon(const double *v, int count, reduceacc_t *acc)
+{
+  float64x2_t  vmin = vdupq_n_f64(acc->min);
+  float64x2_t  vmax = vdupq_n_f64(acc->max);
+  float64x2_t  vsum = vdupq_n_f64(0);
+  float64x2_t  vsq  = vdupq_n_f64(0);
+  float64x2_t  x;
+  double       l[4][2];
+  int          i;
+
+    for (i = 0;  i + 2 <= count;  i += 2)
+    {
+        x    = vld1q_f64(v + i);
+        vmin = vminq_f64(vmin, x);
+        vmax = vmaxq_f64(vmax, x);
+        vsum = vaddq_f64(vsum, x);
+        vsq  = vaddq_f64(vsq,  vmulq_f64(x, x));
+    }
+    vst1q_f64(l[0], vmin);
+    vst1q_f64(l[1], vmax);
+    vst1q_f64(l[2], vsum);
+    vst1q_f64(l[3], vsq);
+    ReduceMergeLanes(acc, 2, l[0], l[1], l[2], l[3]);
+    ReduceF64Portable(v + i, count - i, acc);
+}
+#endif /* __aarch64__ */
+
+#endif /* __ARM_NEON */
+
+static decode_f32_t    decode_f32      = DecodeF32Portable;
+static decode_f64_t    decode_f64      = DecodeF64Portable;
+static reduce_f64_t    reduce_f64      = ReduceF64Portable;
+static const char     *decode_kernel   = "portable";
+static pthread_once_t  decode_init_once = PTHREAD_ONCE_INIT;
+
+static void DecodeInit(void)
+{
+  const char *want = getenv("CDR_SIMPLE_DECODE");
+
+    if (want != NULL  &&  strcmp(want, "portable") == 0) return;
+
+#if defined(__x86_64__)  ||  defined(__i386__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1"))
+    {
+        decode_f32    = DecodeF32Sse41;
+        decode_f64    = DecodeF64Sse41;
+        reduce_f64    = ReduceF64Sse41;
+        decode_kernel = "sse4.1";
+    }
+    if (__builtin_cpu_supports("avx2")  &&
+        (want == NULL  ||  strcmp(want, "sse4.1") != 0))
+    {
+        decode_f32    = DecodeF32Avx2;
+        decode_f64    = DecodeF64Avx2;
+        reduce_f64    = ReduceF64Avx2;
+        decode_kernel = "avx2";
+    }
+#elif defined(__ARM_NEON)
+    decode_f32    = DecodeF32Neon;
+#ifdef __aarch64__
+    decode_f64    = DecodeF64Neon;
+    reduce_f64    = ReduceF64Neon;
+#endif
+    decode_kernel = "neon";
+#endif
+}
+
+const char *CdrSimpleBigcDecodeKernel(void)
+{
+    pthread_once(&decode_init_once, DecodeInit);
+    return decode_kernel;
+}
+
+int   CdrSetSimpleBigcScale(int handle, int dataunits, double r, double d)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
+    }
+    if ((dataunits != 1  &&  dataunits != 2  &&  dataunits != 4)  ||  r == 0)
+    {
+        reporterror("%s: invalid dataunits=%d/r=%g", __FUNCTION__, dataunits, r);
+        errno = EINVAL;
+        return -1;
+    }
 
-    localreginfo.count       = NUMLOCALREGS;
-    localreginfo.regs        = syp->localregs;
-    localreginfo.regsinited  = syp->localregsinited;
+    sbp->decode_units = dataunits;
+    sbp->decode_r     = r;
+    sbp->decode_d     = d;
 
-    CdrProcessGrouplist(reason, 0, NULL, &localreginfo, syp->grouplist);
+    return 0;
+}
 
-    for (cid = syp->frs_cid;
-         cid >= 0;
-         cid = scp->nxt_cid)
+/* Common part of Get*Decoded: returns # of samples, *src_p at sample #first */
+static int PrepareBigcDecode(int handle, int first, int count,
+                             const void **src_p, const char *caller)
+{
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             available;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
     {
-        scp = AccessSmplchSlot(cid);
-        if (scp->cb != NULL)
-            scp->cb(cid, scp->k->curv, scp->privptr);
+        reporterror("%s: invalid handle (%d)", caller, handle);
+        errno = EINVAL;
+        return -1;
     }
+    if (first < 0  ||  count < 0)
+    {
+        reporterror("%s: invalid range first=%d count=%d", caller, first, count);
+        errno = EINVAL;
+        return -1;
+    }
+
+    /* A held view is decoded as is, else the current frame is fetched */
+    if (sbp->view_holds == 0  &&  RefreshBigcDatabuf(sbp, 0) != 0)
+    {
+        reporterror("%s: unable to obtain bigc data (%d): %s",
+                    caller, handle, cx_strerror(errno));
+        return -1;
+    }
+
+    available = sbp->datasize / sbp->decode_units;
+    if (first >= available) return 0;
+    if (count > available - first) count = available - first;
+
+    *src_p = sbp->databuf + (size_t)first * sbp->decode_units;
+    pthread_once(&decode_init_once, DecodeInit);
+
+    return count;
 }
 
-static int subsysname_checker(simplesubsys_t *syp, void *privptr)
+int   CdrGetSimpleBigcFloats (int handle, int first, int count, float  *buf)
 {
-  const char *subsysname = privptr;
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  const void     *src;
+  int             n;
+
+    n = PrepareBigcDecode(handle, first, count, &src, __FUNCTION__);
+    if (n > 0  &&  buf != NULL)
+        decode_f32(src, sbp->decode_units, n, buf,
+                   1.0 / sbp->decode_r, -sbp->decode_d);
 
-    return strcasecmp(subsysname, syp->subsysname) == 0;
+    return n;
 }
-static int GetSubsysID(const char *argv0,
-                       const char *caller,
-                       const char *subsysname)
+
+int   CdrGetSimpleBigcDoubles(int handle, int first, int count, double *buf)
 {
-  int             yid;
-  simplesubsys_t *syp;
-  char           *err;
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  const void     *src;
+  int             n;
 
-    /* Check if this subsystem is already loaded */
-    yid = ForeachSubsysSlot(subsysname_checker, subsysname);
-    if (yid >= 0) return yid;
+    n = PrepareBigcDecode(handle, first, count, &src, __FUNCTION__);
+    if (n > 0  &&  buf != NULL)
+        decode_f64(src, sbp->decode_units, n, buf,
+                   1.0 / sbp->decode_r, -sbp->decode_d);
 
-    /* No, should load... */
+    return n;
+}
 
-    /* First, allocate... */
-    yid = GetSubsysSlot();
-    if (yid < 0)
+//// Bigc reductions /////////////////////////////////////////////////
+
+/* Done in BigcEvent(), before callbacks, so results are always of the
+   latest frame.  The frame is decoded block by block into a small
+   buffer that stays in cache, and each block is reduced per decimation
+   bucket; frame stats are merged from buckets (a single bucket when
+   not decimating), so it is one pass over the data either way. */
+
+enum {REDUCE_BLOCK = 1024};  // Samples decoded at a time
+
+static void ReduceAccInit(reduceacc_t *acc)
+{
+    acc->min   = INFINITY;
+    acc->max   = -INFINITY;
+    acc->sum   = 0;
+    acc->sumsq = 0;
+}
+
+static void ReduceFrame(splbigchan_t *sbp)
+{
+  const uint8   *src;
+  size_t         datasize;
+  int            units = sbp->decode_units;
+  double         scale = 1.0 / sbp->decode_r;
+  double         offset = -sbp->decode_d;
+  int            decimate = (sbp->reduce_flags & CDR_SIMPLE_REDUCE_DECIMATE) != 0;
+  double         block[REDUCE_BLOCK];
+  size_t         total;
+  size_t         pos;
+  size_t         bucket_end;
+  int            npoints;
+  int            b;
+  int            n;
+  int            j;
+  int            seg;
+  int            r;
+  reduceacc_t    frame;
+  reduceacc_t    bucket;
+  CdrSimpleBigcFrameStats_t *sp = &(sbp->frame_stats);
+
+    /* A held view must stay intact, so fetch into a scratch buffer then */
+    if (sbp->view_holds == 0)
     {
-        reporterror("%s: unable to allocate subsys-slot", caller);
+        if (RefreshBigcDatabuf(sbp, 0) != 0) goto ERROR;
+        src      = sbp->databuf;
+        datasize = sbp->datasize;
+    }
+    else
+    {
+        if (sbp->reduce_buf == NULL  &&
+            (sbp->reduce_buf = malloc(sbp->max_datasize != 0? sbp->max_datasize : 1)) == NULL)
+            goto ERROR;
+        r = cda_getbigcdata(sbp->bigc_handle, 0, sbp->max_datasize, sbp->reduce_buf);
+        if (r < 0) goto ERROR;
+        src      = sbp->reduce_buf;
+        datasize = r;
+    }
+    pthread_once(&decode_init_once, DecodeInit);
+
+    total   = datasize / units;
+    npoints = 1;
+    if (decimate) npoints = (size_t)(sbp->decim_points) < total? sbp->decim_points : (int)total;
+
+    ReduceAccInit(&frame);
+    ReduceAccInit(&bucket);
+    b          = 0;
+    bucket_end = npoints > 0? total / npoints : 0;
+    for (pos = 0;  pos < total;  pos += n)
+    {
+        n = total - pos < REDUCE_BLOCK? (int)(total - pos) : REDUCE_BLOCK;
+        decode_f64(src + pos * units, units, n, block, scale, offset);
+
+        for (j = 0;  j < n;  j = seg)
+        {
+            seg = bucket_end - pos < (size_t)n? (int)(bucket_end - pos) : n;
+            reduce_f64(block + j, seg - j, &bucket);
+            if (pos + seg < bucket_end) continue;
+
+            /* Bucket #b is complete */
+            if (decimate)
+            {
+                sbp->decim_mins[b] = bucket.min;
+                sbp->decim_maxs[b] = bucket.max;
+            }
+            ReduceMergeLanes(&frame, 1, &bucket.min, &bucket.max, &bucket.sum, &bucket.sumsq);
+            ReduceAccInit(&bucket);
+            b++;
+            bucket_end = (size_t)(((uint64_t)b + 1) * total / npoints);
+        }
+    }
+
+    sbp->decim_count = decimate? npoints : 0;
+    sbp->decim_gen   = sbp->generation;
+    sp->generation   = sbp->generation;
+    sp->count        = total;
+    sp->min          = total > 0? frame.min                     : NAN;
+    sp->max          = total > 0? frame.max                     : NAN;
+    sp->mean         = total > 0? frame.sum / total             : NAN;
+    sp->rms          = total > 0? sqrt(frame.sumsq / total)     : NAN;
+    return;
+
+ ERROR:
+    /* Stale results must not pass for this frame's */
+    sbp->decim_count = 0;
+    sbp->decim_gen   = sbp->generation;
+    bzero(sp, sizeof(*sp));
+    sp->generation   = sbp->generation;
+}
+
+int   CdrSetSimpleBigcReduction(int handle, int flags, int decim_points)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  double         *new_mins = NULL;
+  double         *new_maxs = NULL;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    {
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
         return -1;
     }
-    syp = AccessSubsysSlot(yid);
-    strzcpy(syp->subsysname, subsysname, sizeof(syp->subsysname));
-    syp->mainsid = CDA_SERVERID_ERROR;
-    syp->frs_cid = -1;
-    syp->frs_bid = -1;
+    if ((flags &~ (CDR_SIMPLE_REDUCE_STATS | CDR_SIMPLE_REDUCE_DECIMATE)) != 0  ||
+        ((flags & CDR_SIMPLE_REDUCE_DECIMATE) != 0  &&  decim_points <= 0))
+    {
+        reporterror("%s: invalid flags=%d/decim_points=%d",
+                    __FUNCTION__, flags, decim_points);
+        errno = EINVAL;
+        return -1;
+    }
+    if ((flags & CDR_SIMPLE_REDUCE_DECIMATE) == 0) decim_points = 0;
 
-    /* ...than open... */
-    if (CdrOpenDescription(subsysname, argv0, &(syp->handle), &(syp->info), &err) != 0)
+    if (decim_points > 0  &&
+        ((new_mins = malloc(decim_points * sizeof(*new_mins))) == NULL  ||
+         (new_maxs = malloc(decim_points * sizeof(*new_maxs))) == NULL))
     {
-        reporterror("%s: OpenDescription(\"%s\"): %s",
-                    caller, subsysname, err);
-        goto ERREXIT;
+        safe_free(new_mins);
+        reporterror("%s: unable to allocate %d-points decimation",
+                    __FUNCTION__, decim_points);
+        errno = ENOMEM;
+        return -1;
     }
-    /* ...and use */
-    syp->mainsid = cda_new_server(syp->info->defserver,
-                                  EventProc, lint2ptr(yid),
-                                  CDA_REGULAR);
-    if (syp->mainsid == CDA_SERVERID_ERROR)
+
+    safe_free(sbp->decim_mins);
+    safe_free(sbp->decim_maxs);
+    sbp->decim_mins   = new_mins;
+    sbp->decim_maxs   = new_maxs;
+    sbp->decim_points = decim_points;
+    sbp->decim_count  = 0;
+    sbp->decim_gen    = 0;
+    sbp->reduce_flags = flags;
+    bzero(&(sbp->frame_stats), sizeof(sbp->frame_stats));
+
+    return 0;
+}
+
+int   CdrGetSimpleBigcFrameStats(int handle, CdrSimpleBigcFrameStats_t *stats)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
     {
-        reporterror("%s: cda_new_server(\"%s\"): %s",
-                    caller, syp->info->defserver, cx_strerror(errno));
-        goto ERREXIT;
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
     }
-    if (syp->info->phys_info_count < 0)
+    if ((sbp->reduce_flags & CDR_SIMPLE_REDUCE_STATS) == 0)
     {
-        cda_TMP_register_physinfo_dbase((physinfodb_rec_t *)(syp->info->phys_info));
+        errno = ENOENT;
+        return -1;
     }
-    else
+
+    *stats = sbp->frame_stats;
+
+    return 0;
+}
+
+int   CdrGetSimpleBigcDecimated(int handle, double *mins, double *maxs,
+                                int max_points, int *gen_p)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+  int             count;
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
     {
-        cda_TMP_register_physinfo_dbase(NULL);
-        cda_set_physinfo(syp->mainsid, syp->info->phys_info, syp->info->phys_info_count);
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
+        return -1;
     }
-    syp->grouplist = CdrCvtGroupunits2Grouplist(syp->mainsid, syp->info->grouping);
-    if (syp->grouplist == NULL)
+    if ((sbp->reduce_flags & CDR_SIMPLE_REDUCE_DECIMATE) == 0)
     {
-        reporterror("%s: CdrCvtGroupunits2Grouplist(): %s",
-                    caller, cx_strerror(errno));
-        goto ERREXIT;
+        errno = ENOENT;
+        return -1;
     }
 
-    cda_run_server(syp->mainsid);
+    count = sbp->decim_count < max_points? sbp->decim_count : max_points;
+    if (count < 0) count = 0;
+    if (mins != NULL) memcpy(mins, sbp->decim_mins, count * sizeof(*mins));
+    if (maxs != NULL) memcpy(maxs, sbp->decim_maxs, count * sizeof(*maxs));
+    if (gen_p != NULL) *gen_p = sbp->decim_gen;
 
-    return yid;
+    return count;
+}
 
- ERREXIT:
-    RlsSubsysSlot(yid);
+//// Instrumentation API /////////////////////////////////////////////
 
-    return -1;
+static double PerfElapsed(void)
+{
+    return perf_since == 0? 0 : (PerfNow() - perf_since) / 1e9;
 }
 
-//// Scalar channels support /////////////////////////////////////////
+static int perf_reset_checker(simplesubsys_t *syp, void *privptr __attribute__((unused)))
+{
+    if (syp->perf != NULL) bzero(syp->perf, sizeof(*(syp->perf)));
+    return 0;
+}
 
-static int channame_checker  (simplechan_t *scp, void *privptr)
+int   CdrSimpleEnablePerf(int on)
 {
-  const char *name = privptr;
+  SIMPLE_LOCKED();
+
+    if (on  &&  !perf_on) perf_since = PerfNow();
+    perf_on = on != 0;
 
-    return strcasecmp(name, scp->name) == 0;
+    return 0;
 }
-int   CdrRegisterSimpleChan(const char *name, const char *argv0,
-                            CdrSimpleChanNewValCB_t cb, void *privptr)
+
+int   CdrSimpleResetPerf (void)
 {
-  const char     *dot_p;
-  const char     *k_name;
-  char            subsysname[200];
-  size_t          subsysnamelen;
+  SIMPLE_LOCKED();
+  int             id;
 
-  int             yid;
-  simplesubsys_t *syp;
+    ForeachSubsysSlot(perf_reset_checker, NULL);
+    for (id = 1;  id < smplch_list_allocd;  id++)
+        if (AccessSmplchSlot(id)->perf != NULL)
+            bzero(AccessSmplchSlot(id)->perf, sizeof(CdrSimpleChanPerf_t));
+    for (id = 1;  id < sbigch_list_allocd;  id++)
+        if (AccessSbigchSlot(id)->perf != NULL)
+            bzero(AccessSbigchSlot(id)->perf, sizeof(CdrSimpleBigcPerf_t));
+    perf_since = PerfNow();
 
-  Knob            k;
-  int             cid;
-  simplechan_t   *scp;
+    return 0;
+}
 
-#if OPTION_HAS_PROGRAM_INVOCATION_NAME /* With GNU libc+ld we can determine the true argv[0] */
-    if (progname[0] == '\0') strzcpy(progname, program_invocation_short_name, sizeof(progname));
-#endif /* OPTION_HAS_PROGRAM_INVOCATION_NAME */
+int   CdrGetSimpleSubsysPerf(const char *subsys, CdrSimpleSubsysPerf_t *perf)
+{
+  SIMPLE_LOCKED();
+  int             yid;
+  simplesubsys_t *syp;
 
-    /* Perform checks */
-    if (name == NULL)
+    yid = subsys != NULL? NameIdxFind(&subsys_idx, subsys) : -1;
+    if (yid < 0)
     {
-        reporterror("%s: NULL channel request", __FUNCTION__);
+        reporterror("%s: subsystem \"%s\" isn't loaded", __FUNCTION__, subsys);
+        errno = ENOENT;
         return -1;
     }
-    if (*name == '\0')
+    syp = AccessSubsysSlot(yid);
+
+    if (syp->perf != NULL) *perf = *(syp->perf);
+    else                   bzero(perf, sizeof(*perf));
+    perf->elapsed = PerfElapsed();
+
+    return 0;
+}
+
+int   CdrGetSimpleChanPerf  (int handle, CdrSimpleChanPerf_t *perf)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
     {
-        reporterror("%s: empty channel request", __FUNCTION__);
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
         return -1;
     }
-    dot_p = strchr(name, '.');
-    if (dot_p == NULL)
+
+    if (scp->perf != NULL) *perf = *(scp->perf);
+    else                   bzero(perf, sizeof(*perf));
+    perf->elapsed = PerfElapsed();
+
+    return 0;
+}
+
+int   CdrGetSimpleBigcPerf  (int handle, CdrSimpleBigcPerf_t *perf)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
     {
-        reporterror("%s: '.'-less channel request \"%s\"", __FUNCTION__, name);
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
         return -1;
     }
-    /* If this was already registered -- just return its id */
-    cid = ForeachSmplchSlot(channame_checker, name);
-    if (cid >= 0) return cid;
 
-    k_name = dot_p + 1;
+    if (sbp->perf != NULL) *perf = *(sbp->perf);
+    else                   bzero(perf, sizeof(*perf));
+    perf->elapsed = PerfElapsed();
 
-    /* Obtain subsys name */
-    subsysnamelen = dot_p - name;
-    if (subsysnamelen > sizeof(subsysname) - 1)
-        subsysnamelen = sizeof(subsysname) - 1;
-    memcpy(subsysname, name, subsysnamelen); subsysname[subsysnamelen] = '\0';
+    return 0;
+}
 
-    /* ...and reference */
-    yid = GetSubsysID(argv0, __FUNCTION__, subsysname);
-    if (yid < 0) return -1;
-    syp = AccessSubsysSlot(yid);
+//// Unregistration //////////////////////////////////////////////////
 
-    k = datatree_FindNode(syp->grouplist, k_name);
-    if (k == NULL)
+static void SubsysUnref(int yid)
+{
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+
+    if (--(syp->refcount) == 0) DropSubsys(yid);
+}
+
+static void ReleaseSimpleChan(int cid)
+{
+  simplechan_t   *scp = AccessSmplchSlot(cid);
+  int             yid = scp->yid;
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  int            *np;
+
+    for (np = &(syp->frs_cid);  *np != cid;  np = &(AccessSmplchSlot(*np)->nxt_cid));
+    *np = scp->nxt_cid;
+    syp->nchans--;
+    CancelWrite(syp, cid);
+
+    RlsSmplchSlot(cid);
+    scp->quarantined = simple_threaded;
+    scp->released_at = __atomic_load_n(&updq_tail, __ATOMIC_RELAXED);
+    SubsysUnref(yid);
+}
+
+static void ReleaseSimpleBigc(int bid)
+{
+  splbigchan_t   *sbp = AccessSbigchSlot(bid);
+  int             yid = sbp->yid;
+  simplesubsys_t *syp = AccessSubsysSlot(yid);
+  bigcsrv_t      *svp = AccessBigcsrvSlot(sbp->srv_id);
+  int            *np;
+
+    for (np = &(syp->frs_bid);  *np != bid;  np = &(AccessSbigchSlot(*np)->nxt_bid));
+    *np = sbp->nxt_bid;
+    for (np = &(svp->frs_bid);  *np != bid;  np = &(AccessSbigchSlot(*np)->nxt_srv_bid));
+    *np = sbp->nxt_srv_bid;
+
+    cda_del_bigc(sbp->bigc_handle);
+    if (--(svp->refcount) == 0) RlsBigcsrvSlot(sbp->srv_id);
+
+    RlsSbigchSlot(bid);
+    sbp->quarantined = simple_threaded;
+    sbp->released_at = __atomic_load_n(&updq_tail, __ATOMIC_RELAXED);
+    SubsysUnref(yid);
+}
+
+static void ReapDeferred(void)
+{
+  int             id;
+
+    for (id = 1;  id < smplch_list_allocd;  id++)
+        if (AccessSmplchSlot(id)->in_use  &&  AccessSmplchSlot(id)->dying)
+            ReleaseSimpleChan(id);
+    for (id = 1;  id < sbigch_list_allocd;  id++)
+        if (AccessSbigchSlot(id)->in_use  &&  AccessSbigchSlot(id)->dying)
+            ReleaseSimpleBigc(id);
+
+    deferred_releases = 0;
+}
+
+int   CdrUnregisterSimpleChan(int handle)
+{
+  SIMPLE_LOCKED();
+  simplechan_t   *scp = AccessSmplchSlot(handle);
+
+    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0  ||
+        scp->dying)
     {
-        reporterror("%s: node \"%s\" not found",
-                    __FUNCTION__, name);
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
         return -1;
     }
-    if (k->type == LOGT_SUBELEM)
+
+    if (dispatch_depth > 0)
     {
-        reporterror("%s: attempt to use subelem (\"%s\")",
-                    __FUNCTION__, name);
-        return -1;
+        /* Atomic: dispatching batches check it unlocked */
+        __atomic_store_n(&(scp->dying), 1, __ATOMIC_RELAXED);
+        deferred_releases++;
+        return 0;
     }
 
-    cid = GetSmplchSlot();
-    if (cid < 0)
+    ReleaseSimpleChan(handle);
+
+    return 0;
+}
+
+int   CdrUnregisterSimpleBigc(int handle)
+{
+  SIMPLE_LOCKED();
+  splbigchan_t   *sbp = AccessSbigchSlot(handle);
+
+    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0  ||
+        sbp->dying)
     {
-        reporterror("%s: unable to allocate chan-slot", __FUNCTION__);
+        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        errno = EINVAL;
         return -1;
     }
-    scp = AccessSmplchSlot(cid);
-    if ((scp->name = strdup(name)) == NULL)
+    /* The caller still has a pointer into databuf */
+    if (sbp->view_holds > 0)
     {
-        reporterror("%s: unable to allocate chan-slot.name", __FUNCTION__);
-        RlsSmplchSlot(cid);
+        reporterror("%s: view of bigc %d is still acquired", __FUNCTION__, handle);
+        errno = EBUSY;
         return -1;
     }
 
-    scp->yid     = yid;
-    scp->k       = k;
-    scp->cb      = cb;
-    scp->privptr = privptr;
+    if (dispatch_depth > 0)
+    {
+        __atomic_store_n(&(sbp->dying), 1, __ATOMIC_RELAXED);
+        deferred_releases++;
+        return 0;
+    }
 
-    /* Add to the head of callback-queue */
-    scp->nxt_cid = syp->frs_cid; syp->frs_cid = cid;
+    ReleaseSimpleBigc(handle);
+
+    return 0;
+}
+
+//// Binary logging ////////////////////////////////////////////////
+
+/* The event loop appends records to lp->bufs[lp->fill]; the writer
+   thread swaps buffers (when the filled one is full, or every
+   SIMPLELOG_FLUSH_PERIOD) and writes the other one outside the lock, so
+   disk latency never stalls the event loop. */
+
+static const double SIMPLELOG_FLUSH_PERIOD = 0.25;
+
+static int LogWriteAll(int fd, const void *buf, size_t size)
+{
+  const uint8 *p = buf;
+  ssize_t      r;
 
-    return cid;
+    while (size > 0)
+    {
+        r = write(fd, p, size);
+        if (r < 0)
+        {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        p    += r;
+        size -= r;
+    }
+
+    return 0;
 }
 
-int   CdrSetSimpleChanVal  (int handle, double  val)
+static int LogOpenFile(simplelog_t *lp)
 {
-  simplechan_t   *scp = AccessSmplchSlot(handle);
-  simplesubsys_t *syp;
+  char                  path[PATH_MAX];
+  CdrSimpleLogHeader_t *hp = (CdrSimpleLogHeader_t *)(lp->header);
 
-  cda_localreginfo_t  localreginfo;
+    if (lp->rotate_size > 0)
+        snprintf(path, sizeof(path), "%s.%04d", lp->filename, lp->file_seq);
+    else
+        strzcpy (path, lp->filename, sizeof(path));
 
-    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    lp->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (lp->fd < 0) return -1;
+
+    hp->start_time = SimpleTimestamp();
+    if (LogWriteAll(lp->fd, lp->header, lp->header_size) != 0)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        close(lp->fd);
+        lp->fd = -1;
         return -1;
     }
+    lp->file_seq++;
+    lp->file_size = lp->header_size;
+    lp->dirty     = 1;
 
-    syp = AccessSubsysSlot(scp->yid);
-    localreginfo.count       = NUMLOCALREGS;
-    localreginfo.regs        = syp->localregs;
-    localreginfo.regsinited  = syp->localregsinited;
+    return 0;
+}
 
-    return CdrSetKnobValue(scp->k, val, 0, &localreginfo);
+static void LogCloseFile(simplelog_t *lp)
+{
+    if (lp->fd < 0) return;
+    if (lp->fsync_interval > 0) fdatasync(lp->fd);
+    close(lp->fd);
+    lp->fd = -1;
 }
 
-int   CdrGetSimpleChanVal  (int handle, double *val_p)
+/* Runs in the writer thread; returns the # of records not written */
+static int LogWriteRecords(simplelog_t *lp, const CdrSimpleLogRecord_t *recs, int count)
 {
-  simplechan_t   *scp = AccessSmplchSlot(handle);
+  size_t  part;
+  size_t  room;
 
-    if (handle < 0  ||  handle >= smplch_list_allocd  ||  scp->in_use == 0)
+    while (count > 0)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
-        return -1;
-    }
+        if (lp->fd < 0  &&  LogOpenFile(lp) != 0) return count;
 
-    *val_p = scp->k->curv;
+        part = count;
+        if (lp->rotate_size > 0)
+        {
+            room = lp->rotate_size > lp->file_size?
+                   (lp->rotate_size - lp->file_size) / sizeof(*recs) : 0;
+            /* Each file gets at least one record, however small rotate_size is */
+            if (room == 0  &&  lp->file_size == lp->header_size) room = 1;
+            if (room == 0)
+            {
+                LogCloseFile(lp);
+                continue;
+            }
+            if (part > room) part = room;
+        }
+
+        if (LogWriteAll(lp->fd, recs, part * sizeof(*recs)) != 0) return count;
+        lp->file_size += part * sizeof(*recs);
+        lp->dirty      = 1;
+        recs  += part;
+        count -= part;
+    }
 
     return 0;
 }
 
-//// Big-channels support ////////////////////////////////////////////
+static void *LogWriterProc(void *arg)
+{
+  simplelog_t     *lp = arg;
+  logbuf_t        *bp;
+  struct timespec  deadline;
+  double           t;
+  int              stop;
+  int              lost;
+  int              err;
 
-static void bigc_event_proc(cda_serverid_t  sid       __attribute__((unused)),
-                            int             reason,
-                            void           *privptr)
+    pthread_mutex_lock(&(lp->mutex));
+    for (;;)
+    {
+        t = SimpleTimestamp() + SIMPLELOG_FLUSH_PERIOD;
+        deadline.tv_sec  = (time_t)t;
+        deadline.tv_nsec = (long)((t - deadline.tv_sec) * 1e9);
+        while (!lp->stop  &&  lp->bufs[lp->fill].count < SIMPLELOG_BUF_RECS)
+            if (pthread_cond_timedwait(&(lp->cond), &(lp->mutex), &deadline) == ETIMEDOUT)
+                break;
+
+        /* The other buffer is always empty here, since only we empty it */
+        bp       = lp->bufs + lp->fill;
+        lp->fill = !lp->fill;
+        stop     = lp->stop;
+        pthread_mutex_unlock(&(lp->mutex));
+
+        lost = LogWriteRecords(lp, bp->recs, bp->count);
+        err  = errno;
+        if (lost > 0  &&  err != lp->write_errno)
+            reporterror("%s: writing \"%s\": %s",
+                        __FUNCTION__, lp->filename, cx_strerror(err));
+        if (lp->fsync_interval > 0  &&  lp->dirty  &&  lp->fd >= 0  &&
+            (stop  ||  SimpleTimestamp() - lp->last_fsync >= lp->fsync_interval))
+        {
+            fdatasync(lp->fd);
+            lp->dirty      = 0;
+            lp->last_fsync = SimpleTimestamp();
+        }
+
+        pthread_mutex_lock(&(lp->mutex));
+        lp->write_errno = lost > 0? err : 0;
+        lp->written    += bp->count - lost;
+        lp->dropped    += lost;
+        bp->count       = 0;
+        if (stop) break;
+    }
+    pthread_mutex_unlock(&(lp->mutex));
+
+    return NULL;
+}
+
+/* Removes log_id from channels' lists; handles were checked at open,
+   but may have been unregistered (or even reused) since */
+static void LogDetachChans(int log_id)
 {
-  int             bid = ptr2lint(privptr);
-  splbigchan_t   *sbp = AccessSbigchSlot(bid);
+  simplelog_t   *lp = AccessSimplelogSlot(log_id);
+  simplechan_t  *scp;
+  int            i;
+  int            n;
 
-    if (sbp->cb != 0)
-        sbp->cb(bid, sbp->privptr);
+    for (i = 0;  i < lp->count;  i++)
+    {
+        scp = AccessSmplchSlot(lp->handles[i]);
+        if (scp->in_use == 0) continue;
+        for (n = 0;  n < scp->log_ids_count;  n++)
+            if (scp->log_ids[n] == log_id)
+            {
+                scp->log_ids[n] = scp->log_ids[--(scp->log_ids_count)];
+                break;
+            }
+    }
 }
 
-static int bigcname_checker  (splbigchan_t *sbp, void *privptr)
+static int LogAttachChan(simplechan_t *scp, int log_id)
 {
-  const char *name = privptr;
+  int   *new_ids;
+  int    new_allocd;
+  int    n;
+
+    for (n = 0;  n < scp->log_ids_count;  n++)
+        if (scp->log_ids[n] == log_id) return 0;  // A duplicate handle
+
+    if (scp->log_ids_count >= scp->log_ids_allocd)
+    {
+        new_allocd = scp->log_ids_allocd * 2 + 1;
+        new_ids    = realloc(scp->log_ids, new_allocd * sizeof(*new_ids));
+        if (new_ids == NULL) return -1;
+        scp->log_ids        = new_ids;
+        scp->log_ids_allocd = new_allocd;
+    }
+    scp->log_ids[scp->log_ids_count++] = log_id;
 
-    return strcasecmp(name, sbp->name) == 0;
+    return 0;
 }
-int   CdrRegisterSimpleBigc(const char *name, const char *argv0,
-                            size_t max_datasize,
-                            CdrSimpleChanNewBigCB_t cb, void *privptr)
+
+/* Entries are padded so that the next one (and the records) stay aligned */
+static size_t LogEntrySize(size_t name_len)
 {
-  const char     *dot_p;
-  const char     *k_name;
-  char            subsysname[200];
-  size_t          subsysnamelen;
+    return (sizeof(CdrSimpleLogChanEntry_t) + name_len + 1 + 7) &~ (size_t)7;
+}
 
-  int             yid;
-  simplesubsys_t *syp;
+/* Returns the entry at p if it (with its '\0'-terminated name) fits
+   before end, else NULL */
+static const CdrSimpleLogChanEntry_t *LogFileEntry(const uint8 *p, const uint8 *end)
+{
+  const CdrSimpleLogChanEntry_t  *ep = (const CdrSimpleLogChanEntry_t *)p;
 
-  Knob            k;
-  int             bid;
-  splbigchan_t   *sbp;
+    if (p > end  ||  (size_t)(end - p) < sizeof(*ep))   return NULL;
+    if ((size_t)(end - p) < LogEntrySize(ep->name_len)) return NULL;
+    if (((const char *)(ep + 1))[ep->name_len] != '\0') return NULL;
 
-  int             bigc_n;
-  const char     *ph_srvref;
-  int             ph_chan_n;
-  cda_serverid_t  ph_defsid;
+    return ep;
+}
 
-#if OPTION_HAS_PROGRAM_INVOCATION_NAME /* With GNU libc+ld we can determine the true argv[0] */
-    if (progname[0] == '\0') strzcpy(progname, program_invocation_short_name, sizeof(progname));
-#endif /* OPTION_HAS_PROGRAM_INVOCATION_NAME */
+static int LogBuildHeader(simplelog_t *lp)
+{
+  CdrSimpleLogHeader_t    *hp;
+  CdrSimpleLogChanEntry_t *ep;
+  size_t                   size;
+  const char              *name;
+  int                      i;
 
-    /* Perform checks */
-    if (name == NULL)
-    {
-        reporterror("%s: NULL bigchan request", __FUNCTION__);
-        return -1;
-    }
-    if (*name == '\0')
-    {
-        reporterror("%s: empty bigchan request", __FUNCTION__);
-        return -1;
-    }
-    dot_p = strchr(name, '.');
-    if (dot_p == NULL)
+    size = sizeof(*hp);
+    for (i = 0;  i < lp->count;  i++)
+        size += LogEntrySize(strlen(AccessSmplchSlot(lp->handles[i])->name));
+
+    if ((lp->header = calloc(1, size)) == NULL) return -1;
+    lp->header_size = size;
+
+    hp = (CdrSimpleLogHeader_t *)(lp->header);
+    memcpy(hp->magic, CDR_SIMPLE_LOG_MAGIC, sizeof(hp->magic));
+    hp->version     = CDR_SIMPLE_LOG_VERSION;
+    hp->record_size = sizeof(CdrSimpleLogRecord_t);
+    hp->num_chans   = lp->count;
+    hp->data_offset = size;
+
+    size = sizeof(*hp);
+    for (i = 0;  i < lp->count;  i++)
     {
-        reporterror("%s: '.'-less bigchan request \"%s\"", __FUNCTION__, name);
-        return -1;
+        name = AccessSmplchSlot(lp->handles[i])->name;
+        ep   = (CdrSimpleLogChanEntry_t *)(lp->header + size);
+        ep->handle   = lp->handles[i];
+        ep->name_len = strlen(name);
+        memcpy(ep + 1, name, ep->name_len);
+        size += LogEntrySize(ep->name_len);
     }
-    /* If this was already registered -- just return its id */
-    bid = ForeachSbigchSlot(bigcname_checker, name);
-    if (bid >= 0) return bid;
 
-    k_name = dot_p + 1;
-
-    /* Obtain subsys name */
-    subsysnamelen = dot_p - name;
-    if (subsysnamelen > sizeof(subsysname) - 1)
-        subsysnamelen = sizeof(subsysname) - 1;
-    memcpy(subsysname, name, subsysnamelen); subsysname[subsysnamelen] = '\0';
+    return 0;
+}
 
-    /* ...and reference */
-    yid = GetSubsysID(argv0, __FUNCTION__, subsysname);
-    if (yid < 0) return -1;
-    syp = AccessSubsysSlot(yid);
+int   CdrOpenSimpleLog(const char *filename, const int *handles, int count,
+                       size_t rotate_size, double fsync_interval)
+{
+  SIMPLE_LOCKED();
+  int            log_id;
+  simplelog_t   *lp;
+  simplechan_t  *scp;
+  size_t         bufsize = SIMPLELOG_BUF_RECS * sizeof(CdrSimpleLogRecord_t);
+  int            i;
+  int            r;
 
-    k = datatree_FindNode(syp->grouplist, k_name);
-    if (k == NULL)
+    if (filename == NULL  ||  handles == NULL  ||  count <= 0)
     {
-        reporterror("%s: node \"%s\" not found",
-                    __FUNCTION__, name);
+        reporterror("%s: filename and at least one handle are required", __FUNCTION__);
+        errno = EINVAL;
         return -1;
     }
-    if (k->type == LOGT_SUBELEM)
+    for (i = 0;  i < count;  i++)
     {
-        reporterror("%s: attempt to use subelem (\"%s\")",
-                    __FUNCTION__, name);
-        return -1;
+        scp = AccessSmplchSlot(handles[i]);
+        if (handles[i] < 0  ||  handles[i] >= smplch_list_allocd  ||
+            scp->in_use == 0  ||  scp->k == NULL  ||  scp->dying)
+        {
+            reporterror("%s: invalid handle (%d)", __FUNCTION__, handles[i]);
+            errno = EINVAL;
+            return -1;
+        }
     }
 
-    bid = GetSbigchSlot();
-    if (bid < 0)
-    {
-        reporterror("%s: unable to allocate bigc-slot", __FUNCTION__);
-        return -1;
-    }
-    sbp = AccessSbigchSlot(bid);
-    if ((sbp->name = strdup(name)) == NULL)
+    log_id = GetSimplelogSlot();
+    if (log_id < 0)
     {
-        reporterror("%s: unable to allocate bigc-slot.name", __FUNCTION__);
-        RlsSbigchSlot(bid);
+        reporterror("%s: unable to allocate log slot", __FUNCTION__);
+        errno = ENOMEM;
         return -1;
     }
+    lp = AccessSimplelogSlot(log_id);
+    lp->fd             = -1;
+    lp->count          = count;
+    lp->rotate_size    = rotate_size;
+    lp->fsync_interval = fsync_interval;
+    lp->last_fsync     = SimpleTimestamp();
 
-    sbp->yid     = yid;
-    sbp->k       = k;
-    sbp->cb      = cb;
-    sbp->privptr = privptr;
-
-    /* Obtain address data... */
-    bigc_n = k->color;
-    if (k->kind == LOGK_DIRECT  &&
-        cda_srcof_physchan(k->physhandle, &ph_srvref, &ph_chan_n) == 1)
+    if ((lp->filename     = strdup(filename))                        == NULL  ||
+        (lp->handles      = malloc(count * sizeof(*(lp->handles))))  == NULL  ||
+        (lp->bufs[0].recs = malloc(bufsize))                         == NULL  ||
+        (lp->bufs[1].recs = malloc(bufsize))                         == NULL  ||
+        (memcpy(lp->handles, handles, count * sizeof(*handles)),
+         LogBuildHeader(lp) != 0))
     {
-        ph_defsid = cda_sidof_physchan(k->physhandle);
+        reporterror("%s: unable to allocate log buffers", __FUNCTION__);
+        errno = ENOMEM;
+        goto CLEANUP;
     }
-    else
+
+    /* Open the first file right away, so that a bad path is reported here */
+    if (LogOpenFile(lp) != 0)
     {
-        ph_srvref = NULL;
-        ph_chan_n = -1;
-        ph_defsid = CDA_SERVERID_ERROR;
+        reporterror("%s: unable to create \"%s\": %s",
+                    __FUNCTION__, filename, cx_strerror(errno));
+        goto CLEANUP;
     }
-    /* ...and try to bind */
-    sbp->bigc_sid = cda_new_server(ph_srvref,
-                                   bigc_event_proc, lint2ptr(bid),
-                                   CDA_BIGC);
-    if (sbp->bigc_sid == CDA_SERVERID_ERROR)
+
+    pthread_mutex_init(&(lp->mutex), NULL);
+    pthread_cond_init (&(lp->cond),  NULL);
+    lp->sync_inited = 1;
+
+    for (i = 0;  i < count;  i++)
+        if (LogAttachChan(AccessSmplchSlot(handles[i]), log_id) != 0)
+        {
+            LogDetachChans(log_id);
+            reporterror("%s: unable to attach channels", __FUNCTION__);
+            errno = ENOMEM;
+            goto CLEANUP;
+        }
+
+    r = pthread_create(&(lp->thread), NULL, LogWriterProc, lp);
+    if (r != 0)
     {
-        reporterror("%s: cda_new_server(server=%s): %s",
-                   __FUNCTION__, ph_srvref, cx_strerror(errno));
+        LogDetachChans(log_id);
+        reporterror("%s: pthread_create(): %s", __FUNCTION__, cx_strerror(r));
+        errno = r;
         goto CLEANUP;
     }
-    sbp->bigc_handle = cda_add_bigc(sbp->bigc_sid, bigc_n,
-                                    CX_MAX_BIGC_PARAMS, max_datasize,
-                                    CX_CACHECTL_SHARABLE, 
-                                    CX_BIGC_IMMED_YES);
-    cda_run_server(sbp->bigc_sid);
 
-    /* Add to the head of callback-queue */
-    sbp->nxt_bid = syp->frs_bid; syp->frs_bid = bid;
-
-    return bid;
+    return log_id;
 
  CLEANUP:
+    RlsSimplelogSlot(log_id);
     return -1;
 }
 
-int   CdrGetSimpleBigcData (int handle, int byte_ofs, int byte_size, void *buf)
+int   CdrCloseSimpleLog(int log_id)
 {
-  splbigchan_t   *sbp = AccessSbigchSlot(handle);
-  int             r;
+  simplelog_t   *lp;
 
-    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    SimpleLock();
+    lp = AccessSimplelogSlot(log_id);
+    if (log_id < 0  ||  log_id >= simplelog_list_allocd  ||  lp->in_use == 0  ||
+        lp->closing)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        SimpleUnlock();
+        reporterror("%s: invalid log id (%d)", __FUNCTION__, log_id);
+        errno = EINVAL;
         return -1;
     }
 
-    r = cda_getbigcdata(sbp->bigc_handle, byte_ofs, byte_size, buf);
+    /* No more records after this point; the writer flushes what's left */
+    LogDetachChans(log_id);
+    lp->closing = 1;
+    pthread_mutex_lock(&(lp->mutex));
+    lp->stop = 1;
+    pthread_cond_signal(&(lp->cond));
+    pthread_mutex_unlock(&(lp->mutex));
+    SimpleUnlock();
 
-    return r;
+    /* The final flush may take long, the event loop mustn't wait for it
+       (the slot stays allocated, so lp is valid) */
+    pthread_join(lp->thread, NULL);
+
+    SimpleLock();
+    RlsSimplelogSlot(log_id);
+    SimpleUnlock();
+
+    return 0;
 }
 
-int   CdrSetSimpleBigcData (int handle, int byte_ofs, int byte_size, void *buf, int dataunits)
+int   CdrGetSimpleLogStats(int log_id, uint64_t *written_p, uint64_t *dropped_p)
 {
-  splbigchan_t   *sbp = AccessSbigchSlot(handle);
-  int             r;
+  SIMPLE_LOCKED();
+  simplelog_t   *lp = AccessSimplelogSlot(log_id);
 
-    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    if (log_id < 0  ||  log_id >= simplelog_list_allocd  ||  lp->in_use == 0)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        reporterror("%s: invalid log id (%d)", __FUNCTION__, log_id);
+        errno = EINVAL;
         return -1;
     }
 
-    r = cda_setbigcdata(sbp->bigc_handle, byte_ofs, byte_size, buf, dataunits);
+    pthread_mutex_lock(&(lp->mutex));
+    if (written_p != NULL) *written_p = lp->written;
+    if (dropped_p != NULL) *dropped_p = lp->dropped;
+    pthread_mutex_unlock(&(lp->mutex));
 
-    return r;
+    return 0;
 }
 
+/* Readers touch no library state, so they take no lock */
 
-int   CdrGetSimpleBigcStats(int handle, int *age_p, int *rflags_p)
+int   CdrOpenSimpleLogFile(const char *path, CdrSimpleLogFile_t *lf)
 {
-  splbigchan_t   *sbp = AccessSbigchSlot(handle);
-  int             r;
-  tag_t           tag;    // Note: these two are of cx-specific types,
-  rflags_t        rflags; //       while parameters are just 'int' ("simple"!)
+  int                          fd;
+  struct stat                  st;
+  void                        *map;
+  const CdrSimpleLogHeader_t  *hp;
+  const uint8                 *p;
+  const CdrSimpleLogChanEntry_t *ep;
+  uint32_t                     i;
 
-    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    bzero(lf, sizeof(*lf));
+
+    if ((fd = open(path, O_RDONLY)) < 0) return -1;
+    if (fstat(fd, &st) != 0)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        close(fd);
+        return -1;
+    }
+    if ((size_t)(st.st_size) < sizeof(*hp))
+    {
+        close(fd);
+        errno = EINVAL;
         return -1;
     }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return -1;
 
-    r = cda_getbigcstats(sbp->bigc_handle, &tag, &rflags);
-    if (r > 0)
+    hp = map;
+    if (memcmp(hp->magic, CDR_SIMPLE_LOG_MAGIC, sizeof(hp->magic)) != 0  ||
+        hp->version     != CDR_SIMPLE_LOG_VERSION                        ||
+        hp->record_size != sizeof(CdrSimpleLogRecord_t)                  ||
+        hp->data_offset <  sizeof(*hp)                                   ||
+        hp->data_offset >  (size_t)(st.st_size))
+        goto BADFILE;
+    /* All chan entries must lie before the data */
+    for (i = 0, p = (const uint8 *)(hp + 1);  i < hp->num_chans;  i++)
     {
-        if (age_p    != NULL) *age_p    = tag;
-        if (rflags_p != NULL) *rflags_p = rflags;
+        ep = LogFileEntry(p, (const uint8 *)map + hp->data_offset);
+        if (ep == NULL) goto BADFILE;
+        p += LogEntrySize(ep->name_len);
     }
 
-    return r;
+    lf->map         = map;
+    lf->map_size    = st.st_size;
+    lf->header      = hp;
+    lf->records     = (const CdrSimpleLogRecord_t *)((const uint8 *)map + hp->data_offset);
+    /* A partially written tail record (of a live or crashed log) is ignored */
+    lf->num_records = (st.st_size - hp->data_offset) / hp->record_size;
+
+    return 0;
+
+ BADFILE:
+    munmap(map, st.st_size);
+    errno = EINVAL;
+    return -1;
 }
 
+const char *CdrSimpleLogFileChanName(const CdrSimpleLogFile_t *lf, int handle)
+{
+  const uint8                    *p = (const uint8 *)(lf->header + 1);
+  const uint8                    *end;
+  const CdrSimpleLogChanEntry_t  *ep;
+  uint32_t                        i;
 
-int   CdrGetSimpleBigcParam(int handle, int n, int *val_p)
+    if (lf->header == NULL) return NULL;
+    end = (const uint8 *)(lf->map) + lf->header->data_offset;
+
+    for (i = 0;  i < lf->header->num_chans;  i++)
+    {
+        if ((ep = LogFileEntry(p, end)) == NULL) return NULL;
+        if (ep->handle == handle) return (const char *)(ep + 1);
+        p += LogEntrySize(ep->name_len);
+    }
+
+    return NULL;
+}
+
+int   CdrCloseSimpleLogFile(CdrSimpleLogFile_t *lf)
 {
-  splbigchan_t   *sbp = AccessSbigchSlot(handle);
-  int             r;
-  int32           v;
+    if (lf->map != NULL) munmap(lf->map, lf->map_size);
+    bzero(lf, sizeof(*lf));
 
-    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    return 0;
+}
+
+//// Snapshots ///////////////////////////////////////////////////////
+
+/* Channels are matched by name on restore, since handles are
+   per-process; file is built in memory and renamed into place, so a
+   reader never sees a half-written snapshot */
+
+static int SnapChanValid(int cid)
+{
+  simplechan_t *scp = AccessSmplchSlot(cid);
+
+    return cid >= 0  &&  cid < smplch_list_allocd  &&
+           scp->in_use != 0  &&  scp->k != NULL  &&  !scp->dying;
+}
+
+int   CdrSaveSimpleSnapshot(const char *path, const int *handles, int count)
+{
+  SIMPLE_LOCKED();
+  CdrSimpleSnapHeader_t  *hp;
+  CdrSimpleSnapEntry_t   *ep;
+  simplechan_t           *scp;
+  uint8                  *buf  = NULL;
+  int                    *all  = NULL;
+  size_t                  names_size;
+  size_t                  size;
+  char                    tmppath[PATH_MAX];
+  int                     fd;
+  int                     i;
+  int                     r = -1;
+
+    if (count < 0)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        reporterror("%s: negative count (%d)", __FUNCTION__, count);
+        errno = EINVAL;
         return -1;
     }
 
-    r = cda_getbigcparams(sbp->bigc_handle, n, 1, &v);
-    if (r > 0) *val_p = v;
+    /* No handles -- all registered channels (an empty list means none) */
+    if (handles == NULL)
+    {
+        if ((all = malloc((smplch_list_allocd + 1) * sizeof(*all))) == NULL)
+        {
+            reporterror("%s: unable to allocate handles list", __FUNCTION__);
+            errno = ENOMEM;
+            return -1;
+        }
+        for (i = 0, count = 0;  i < smplch_list_allocd;  i++)
+            if (SnapChanValid(i)) all[count++] = i;
+        handles = all;
+    }
+    else
+        for (i = 0;  i < count;  i++)
+            if (!SnapChanValid(handles[i]))
+            {
+                reporterror("%s: invalid handle [%d]=%d", __FUNCTION__, i, handles[i]);
+                errno = EINVAL;
+                return -1;
+            }
+
+    for (i = 0, names_size = 0;  i < count;  i++)
+        names_size += strlen(AccessSmplchSlot(handles[i])->name) + 1;
+    size = sizeof(*hp) + count * sizeof(*ep) + names_size;
+    if ((buf = calloc(1, size)) == NULL)
+    {
+        reporterror("%s: unable to allocate %zu-bytes snapshot", __FUNCTION__, size);
+        errno = ENOMEM;
+        goto CLEANUP;
+    }
+
+    /* The single pass over live values */
+    hp = (CdrSimpleSnapHeader_t *)buf;
+    ep = (CdrSimpleSnapEntry_t  *)(hp + 1);
+    memcpy(hp->magic, CDR_SIMPLE_SNAP_MAGIC, sizeof(hp->magic));
+    hp->version      = CDR_SIMPLE_SNAP_VERSION;
+    hp->num_chans    = count;
+    hp->names_offset = sizeof(*hp) + count * sizeof(*ep);
+    hp->names_size   = names_size;
+    hp->timestamp    = SimpleTimestamp();
+    for (i = 0, names_size = 0;  i < count;  i++, ep++)
+    {
+        scp = AccessSmplchSlot(handles[i]);
+        ep->value       = scp->k->curv;
+        ep->rflags      = scp->k->currflags;
+        ep->name_offset = names_size;
+        strcpy((char *)(buf + hp->names_offset + names_size), scp->name);
+        names_size += strlen(scp->name) + 1;
+    }
+
+    snprintf(tmppath, sizeof(tmppath), "%s.tmp", path);
+    if ((fd = open(tmppath, O_WRONLY | O_CREAT | O_TRUNC, 0644)) < 0)
+    {
+        reporterror("%s: unable to create \"%s\": %s",
+                    __FUNCTION__, tmppath, cx_strerror(errno));
+        goto CLEANUP;
+    }
+    if (LogWriteAll(fd, buf, size) != 0)
+    {
+        reporterror("%s: unable to write \"%s\": %s",
+                    __FUNCTION__, tmppath, cx_strerror(errno));
+        close(fd);
+        unlink(tmppath);
+        goto CLEANUP;
+    }
+    if (close(fd) != 0  ||  rename(tmppath, path) != 0)
+    {
+        reporterror("%s: unable to save \"%s\": %s",
+                    __FUNCTION__, path, cx_strerror(errno));
+        unlink(tmppath);
+        goto CLEANUP;
+    }
+
+    r = count;
 
+ CLEANUP:
+    safe_free(buf);
+    safe_free(all);
     return r;
 }
 
-
-int   CdrSetSimpleBigcParam(int handle, int n, int  val)
+int   CdrRestoreSimpleSnapshot(const char *path, int mode, double tolerance,
+                               int *nmissing_p, int *nfailed_p)
 {
-  splbigchan_t   *sbp = AccessSbigchSlot(handle);
-  int             r;
-  int32           v;
+  SIMPLE_LOCKED();
+  int                           fd;
+  struct stat                   st;
+  void                         *map;
+  const CdrSimpleSnapHeader_t  *hp;
+  const CdrSimpleSnapEntry_t   *ep;
+  const char                   *names;
+  int                          *handles = NULL;
+  double                       *vals    = NULL;
+  int                           count   = 0;
+  int                           nmissing = 0;
+  int                           nfailed;
+  int                           cid;
+  uint32_t                      i;
+  int                           r = -1;
 
-    if (handle < 0  ||  handle >= sbigch_list_allocd  ||  sbp->in_use == 0)
+    if (mode != CDR_SIMPLE_SNAP_ALL  &&  mode != CDR_SIMPLE_SNAP_DIFF)
     {
-        reporterror("%s: invalid handle (%d)", __FUNCTION__, handle);
+        reporterror("%s: invalid mode %d", __FUNCTION__, mode);
+        errno = EINVAL;
         return -1;
     }
 
-    v = val;
-    r = cda_setbigcparams(sbp->bigc_handle, n, 1, &v);
+    if ((fd = open(path, O_RDONLY)) < 0  ||  fstat(fd, &st) != 0)
+    {
+        reporterror("%s: unable to open \"%s\": %s",
+                    __FUNCTION__, path, cx_strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    map = (size_t)(st.st_size) >= sizeof(*hp)?
+          mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    hp = map;
+    if (map == MAP_FAILED                                                   ||
+        memcmp(hp->magic, CDR_SIMPLE_SNAP_MAGIC, sizeof(hp->magic)) != 0    ||
+        hp->version != CDR_SIMPLE_SNAP_VERSION                              ||
+        hp->names_offset != sizeof(*hp) + (size_t)(hp->num_chans) * sizeof(*ep)  ||
+        (size_t)(hp->names_offset) + hp->names_size > (size_t)(st.st_size)  ||
+        (hp->names_size > 0  &&
+         ((const char *)map)[hp->names_offset + hp->names_size - 1] != '\0'))
+    {
+        reporterror("%s: \"%s\" is not a valid snapshot", __FUNCTION__, path);
+        if (map != MAP_FAILED) munmap(map, st.st_size);
+        errno = EINVAL;
+        return -1;
+    }
+    ep    = (const CdrSimpleSnapEntry_t *)(hp + 1);
+    names = (const char *)map + hp->names_offset;
+
+    if (hp->num_chans > 0  &&
+        ((handles = malloc(hp->num_chans * sizeof(*handles))) == NULL  ||
+         (vals    = malloc(hp->num_chans * sizeof(*vals)))    == NULL))
+    {
+        reporterror("%s: unable to allocate %u items", __FUNCTION__, hp->num_chans);
+        errno = ENOMEM;
+        goto CLEANUP;
+    }
+
+    for (i = 0;  i < hp->num_chans;  i++, ep++)
+    {
+        cid = ep->name_offset < hp->names_size?
+              NameIdxFind(&smplch_idx, names + ep->name_offset) : -1;
+        if (cid < 0  ||  !SnapChanValid(cid))
+        {
+            nmissing++;
+            continue;
+        }
+        /* Measurements and other read-only channels can't be restored */
+        if (AccessSmplchSlot(cid)->k->type != LOGT_WRITE1) continue;
+        if (mode == CDR_SIMPLE_SNAP_DIFF  &&
+            fabs(ep->value - AccessSmplchSlot(cid)->k->curv) <= tolerance)
+            continue;
+        handles[count] = cid;
+        vals   [count] = ep->value;
+        count++;
+    }
+
+    /* The batched path: sorted by subsystem, all handles are valid */
+    if (SetChanVals(handles, vals, count, &nfailed, __FUNCTION__) != 0) goto CLEANUP;
 
+    if (nmissing_p != NULL) *nmissing_p = nmissing;
+    if (nfailed_p  != NULL) *nfailed_p  = nfailed;
+    r = count - nfailed;
+
+ CLEANUP:
+    safe_free(handles);
+    safe_free(vals);
+    munmap(map, st.st_size);
     return r;
 }
 